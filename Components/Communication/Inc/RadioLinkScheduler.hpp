@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ * File Name          : RadioLinkScheduler.hpp
+ * Description        : Token bucket bandwidth scheduler for messages sent over the radio link.
+ *    Messages are classified by importance, lower classes are dropped first when the budget runs low.
+ ******************************************************************************
+*/
+#ifndef SOAR_COMMS_RADIO_LINK_SCHEDULER_HPP_
+#define SOAR_COMMS_RADIO_LINK_SCHEDULER_HPP_
+/* Includes ------------------------------------------------------------------*/
+#include "cmsis_os.h"
+
+/* Enums ------------------------------------------------------------------*/
+// Ordered from highest to lowest priority
+enum RADIO_MSG_CLASS {
+    RADIO_MSG_CLASS_CONTROL = 0,        // Acks and other control responses, never dropped
+    RADIO_MSG_CLASS_STATE,              // Rocket state, vent/drain/MEV status
+    RADIO_MSG_CLASS_SENSOR_HIGH_RATE,   // Barometer, IMU, pressure transducers
+    RADIO_MSG_CLASS_SENSOR_LOW_RATE,    // Battery, GPS
+    RADIO_MSG_NUM_CLASSES
+};
+
+/* Structs -------------------------------------------------------------------*/
+struct RadioClassStats
+{
+    uint32_t sentMsgs;         // Messages admitted to the link
+    uint32_t sentBytes;        // Bytes admitted to the link
+    uint32_t droppedMsgs;      // Messages dropped because the budget ran out
+    uint32_t droppedBytes;     // Bytes dropped because the budget ran out
+};
+
+/* Class -----------------------------------------------------------------*/
+/**
+ * @brief Link-wide token bucket with strict priority between message classes.
+ *
+ * The bucket refills at the configured byte rate up to RADIO_LINK_BUCKET_SIZE_BYTES. A message is admitted
+ * only if the bucket still holds its size plus the reserve of its class. The reserve is zero for the highest
+ * classes and grows for the lower ones, so as the budget runs low low-rate telemetry is dropped first, then
+ * high-rate telemetry, and the remaining budget is kept for state and control. Control messages are always
+ * admitted and may take the bucket into debt, which the lower classes then have to wait out.
+ */
+class RadioLinkScheduler
+{
+public:
+    static bool Admit(RADIO_MSG_CLASS msgClass, uint16_t frameBytes);    // Takes tokens for a frame, returns false if it must be dropped
+
+    static void SetRate(uint32_t bytesPerSec);
+    static uint32_t GetRate() { return rateBytesPerSec_; }
+
+    static bool GetClassStats(RADIO_MSG_CLASS msgClass, RadioClassStats& stats);
+    static void ResetStats();
+    static void PrintStats();    // Prints per-class statistics over the debug UART
+
+private:
+    static void Refill(TickType_t now);
+
+    static int32_t tokens_;                 // Available bytes, negative while control messages are in debt
+    static uint32_t tokenRemainder_;        // Sub-byte refill carried between refills, in bytes x ticks per second
+    static TickType_t lastRefillTick_;      // Tick of the last refill
+    static uint32_t rateBytesPerSec_;       // Refill rate
+    static RadioClassStats stats_[RADIO_MSG_NUM_CLASSES];
+};
+
+#endif    // SOAR_COMMS_RADIO_LINK_SCHEDULER_HPP_
@@ -37,50 +37,102 @@ namespace UART {
 /**
  * @brief Any classes that are expected to receive using a UART driver
  *		  must derive from this base class and provide an implementation
- *		  for InterruptRxData
+ *		  for InterruptRxData (ReceiveIT) or InterruptRxSpan (ReceiveDMA)
  */
 class UARTReceiverBase
 {
 public:
-	virtual void InterruptRxData(uint8_t errors) = 0;
+	virtual void InterruptRxData(uint8_t errors) {}	// Called per byte when receiving with ReceiveIT
+	virtual void InterruptRxSpan(const uint8_t* data, uint16_t len, uint8_t errors) {}	// Called per idle line / half / full buffer when receiving with ReceiveDMA
 };
 
+/* UART Transmitter Base Class ------------------------------------------------------------------*/
+/**
+ * @brief Classes that start DMA transfers without blocking on them derive from this
+ *		  base class to be told, from the ISR, when a transfer has finished
+ */
+class UARTTransmitterBase
+{
+public:
+	virtual void InterruptTxComplete(UARTDriver* uart) = 0;
+};
+
+/* UART DMA Stream ------------------------------------------------------------------*/
+/**
+ * @brief Identifies a DMA stream and the request channel that connects it to a UART
+ */
+struct UARTDMAStream
+{
+	DMA_TypeDef* dma;	// DMA controller, DMA1 or DMA2
+	uint32_t stream;	// LL_DMA_STREAM_x
+	uint32_t channel;	// LL_DMA_CHANNEL_x
+	IRQn_Type irqn;		// Stream interrupt
+};
 
 /* UART Driver Class ------------------------------------------------------------------*/
 /**
- * @brief This is a basic UART driver designed for Interrupt Rx and Polling Tx
- *	      based on the STM32 LL Library
+ * @brief This is a basic UART driver designed for Interrupt or circular DMA Rx and DMA Tx
+ *	      based on the STM32 LL Library. Polling Tx is kept for the assert handler.
  */
 class UARTDriver
 {
 public:
-	UARTDriver(USART_TypeDef* uartInstance) :
+	UARTDriver(USART_TypeDef* uartInstance, const UARTDMAStream& txDma, const UARTDMAStream& rxDma) :
 		kUart_(uartInstance),
+		kTxDma_(txDma),
+		kRxDma_(rxDma),
 		rxCharBuf_(nullptr),
-		rxReceiver_(nullptr) {}
+		rxReceiver_(nullptr),
+		rxDmaBuf_(nullptr),
+		rxDmaSize_(0),
+		rxDmaPos_(0),
+		txNotifyTask_(nullptr),
+		txListener_(nullptr),
+		txBusy_(false),
+		txError_(false) {}
 
 	// Polling Functions
-	bool Transmit(uint8_t* data, uint16_t len);
+	bool Transmit(uint8_t* data, uint16_t len); // Blocks the CPU for the whole frame, only for use where the RTOS can't be relied on (eg. assert)
+
+	// DMA Functions
+	void InitTxDMA();	// Configures the Tx DMA stream, must be called once before TransmitDMA
+	bool TransmitDMA(const uint8_t* data, uint16_t len, UARTTransmitterBase* listener = nullptr); // Starts a transfer, the listener (or calling task) is notified on completion, data must stay valid until then
+	bool WaitTransmitComplete(uint32_t timeout_ms); // Blocks the calling task until the transfer started by TransmitDMA completes, aborts it on timeout
+	void AbortTxDMA(); // Stops the transfer in progress, if any
+	bool IsTransmitBusy() const { return txBusy_; }
+	bool LastTransmitFailed() const { return txError_; } // True if the last transfer ended in a DMA transfer error
+	bool ReceiveDMA(uint8_t* buffer, uint16_t size, UARTReceiverBase* receiver); // Receives continuously into a circular buffer, buffer must not be in CCM RAM
 
 	// Interrupt Functions
 	bool ReceiveIT(uint8_t* charBuf, UARTReceiverBase* receiver);
 
-
 	// Interrupt Handlers
 	void HandleIRQ_UART(); // This MUST be called inside USARTx_IRQHandler
+	void HandleIRQ_TxDMA(); // This MUST be called inside the DMAx_Streamy_IRQHandler of the Tx stream
+	void HandleIRQ_RxDMA(); // This MUST be called inside the DMAx_Streamy_IRQHandler of the Rx stream
 
 protected:
 	// Helper Functions
 	bool HandleAndClearRxError();
 	bool GetRxErrors();
+	void ProcessRxDMA();
 
 
 	// Constants
 	USART_TypeDef* kUart_; // Stores the UART instance
+	const UARTDMAStream kTxDma_; // Tx DMA stream
+	const UARTDMAStream kRxDma_; // Rx DMA stream
 
 	// Variables
 	uint8_t* rxCharBuf_; // Stores a pointer to the buffer to store the received data
 	UARTReceiverBase* rxReceiver_; // Stores a pointer to the receiver object
+	uint8_t* rxDmaBuf_; // Circular Rx DMA buffer
+	uint16_t rxDmaSize_; // Size of the circular Rx DMA buffer
+	uint16_t rxDmaPos_; // Index in rxDmaBuf_ of the first byte not yet passed to the receiver
+	TaskHandle_t txNotifyTask_; // Task to notify when the current DMA transfer completes, if there is no listener
+	UARTTransmitterBase* txListener_; // Listener to call when the current DMA transfer completes
+	volatile bool txBusy_; // True while a DMA transfer is in progress
+	volatile bool txError_; // True if the last DMA transfer ended in a transfer error
 };
 
 
@@ -22,18 +22,46 @@ enum UART_TASK_COMMANDS {
     UART_TASK_COMMAND_MAX
 };
 
+enum UART_TASK_EVENTS {
+    UART_TASK_EVENT_NONE = 0,
+    UART_TASK_EVENT_TX_COMPLETE,    // A channel DMA transfer finished, sent from the ISR on the priority lane
+};
+
+// Each physical UART has its own transmit queue and DMA stream, so a busy channel never delays another
+enum UART_TASK_CHANNEL {
+    UART_TASK_CHANNEL_DEBUG = 0,
+    UART_TASK_CHANNEL_RADIO,
+    UART_TASK_CHANNEL_PBB,
+    UART_TASK_NUM_CHANNELS
+};
+
+/* Structs ------------------------------------------------------------------*/
+struct UARTChannelStats
+{
+    uint32_t bytesSent;        // Bytes successfully transmitted
+    uint32_t framesSent;       // Commands successfully transmitted
+    uint32_t framesFailed;     // Commands whose transfer failed or timed out
+    uint32_t framesDropped;    // Commands dropped because the channel queue was full
+    uint32_t transfers;        // DMA transfers started, less than framesSent when frames are aggregated
+};
+
 
 /* Class ------------------------------------------------------------------*/
-class UARTTask : public Task
+class UARTTask : public Task, public UARTTransmitterBase
 {
 public:
     static UARTTask& Inst() {
-        static UARTTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
 
+    // DMA transmit complete callback
+    void InterruptTxComplete(UARTDriver* uart);
+
+    const Queue* GetChannelQueue(UART_TASK_CHANNEL channel) const { return channels_[channel].queue; }
+    void GetChannelStats(UART_TASK_CHANNEL channel, UARTChannelStats& stats) const;
+
 protected:
     static void RunTask(void* pvParams) { UARTTask::Inst().Run(pvParams); } // Static Task Interface, passes control to the instance Run();
 
@@ -42,10 +70,52 @@ protected:
     void ConfigureUART();
     void HandleCommand(Command& cm);
 
+    struct TxChannel
+    {
+        UARTDriver* uart;            // UART the channel transmits on
+        Queue* queue;                // Commands waiting to be transmitted
+        Command inFlight;            // Command being transmitted, the DMA reads directly from its data
+        bool busy;                   // True while a transfer is in progress
+        bool burstInFlight;          // True if the transfer in progress is from burstBuffer rather than inFlight
+        bool inFlightHeld;           // True while inFlight holds a command, during a burst this is the frame that did not fit
+        TickType_t startTick;        // Tick the transfer was started at, for the timeout
+        uint16_t transferFrames;     // Number of frames in the transfer in progress
+        uint16_t transferBytes;      // Number of bytes in the transfer in progress
+
+        // Aggregation, frames queued within the window are packed into one DMA burst
+        uint8_t* burstBuffer;        // Burst buffer, nullptr if every command is sent as its own transfer
+        uint16_t burstBufferSize;    // Size of burstBuffer in bytes
+        TickType_t windowTicks;      // Max time the oldest queued frame waits for others to join its burst
+        bool pending;                // True while frames are queued and no burst has taken them yet
+        TickType_t pendingTick;      // Tick the oldest pending frame was queued at
+
+        UARTChannelStats stats;
+    };
+
+    // Channel helpers
+    TickType_t GetWaitTicks() const;
+    void QueueTransmit(UART_TASK_CHANNEL channel, Command& cm);
+    void ServiceChannels();
+    void FinishTransmit(TxChannel& ch, bool success);
+    void StartTransmit(TxChannel& ch);
+    void StartBurst(TxChannel& ch);
+
 private:
-    UARTTask() : Task(UART_TASK_QUEUE_DEPTH_OBJS) {}    // Private constructor
+    UARTTask();    // Private constructor
     UARTTask(const UARTTask&);                        // Prevent copy-construction
     UARTTask& operator=(const UARTTask&);            // Prevent assignment
+
+    static UARTTask inst_;    // Singleton instance, defined in the .cpp
+
+    // Static storage
+    StaticQueue<UART_TASK_QUEUE_DEPTH_OBJS, UART_TASK_NUM_CHANNELS * 2> evtQueue_;    // Event queue storage, the priority lane carries transfer complete events
+    StaticQueue<UART_TASK_CHANNEL_QUEUE_DEPTH_OBJS> debugTxQueue_;    // Per-channel transmit queues
+    StaticQueue<UART_TASK_CHANNEL_QUEUE_DEPTH_OBJS> radioTxQueue_;
+    StaticQueue<UART_TASK_CHANNEL_QUEUE_DEPTH_OBJS> pbbTxQueue_;
+    TaskStorage<UART_TASK_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
+
+    TxChannel channels_[UART_TASK_NUM_CHANNELS];
+    uint8_t radioBurstBuffer_[UART_TASK_RADIO_BURST_BUFFER_BYTES];    // Radio frames are aggregated here, DMA source so must not be in CCM RAM
 };
 
 
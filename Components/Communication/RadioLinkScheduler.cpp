@@ -0,0 +1,146 @@
+/**
+ ******************************************************************************
+ * File Name          : RadioLinkScheduler.cpp
+ * Description        : Token bucket bandwidth scheduler for messages sent over the radio link.
+ ******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "RadioLinkScheduler.hpp"
+#include "SystemDefines.hpp"
+
+/* Constants -----------------------------------------------------------------*/
+// Bytes that must remain in the bucket after a message of each class is admitted, implements the strict priority
+static constexpr int32_t CLASS_RESERVE_BYTES[RADIO_MSG_NUM_CLASSES] = {
+    0,                                      // Control (always admitted)
+    0,                                      // State
+    RADIO_LINK_BUCKET_SIZE_BYTES / 4,       // High rate sensor
+    RADIO_LINK_BUCKET_SIZE_BYTES / 2,       // Low rate sensor
+};
+
+static constexpr int32_t MAX_DEBT_BYTES = RADIO_LINK_BUCKET_SIZE_BYTES;    // Lowest the bucket may go when admitting control messages
+
+/* Static Variable Init ------------------------------------------------------*/
+int32_t RadioLinkScheduler::tokens_ = RADIO_LINK_BUCKET_SIZE_BYTES;
+uint32_t RadioLinkScheduler::tokenRemainder_ = 0;
+TickType_t RadioLinkScheduler::lastRefillTick_ = 0;
+uint32_t RadioLinkScheduler::rateBytesPerSec_ = RADIO_LINK_RATE_BYTES_PER_SEC;
+RadioClassStats RadioLinkScheduler::stats_[RADIO_MSG_NUM_CLASSES] = {};
+
+/* Functions -----------------------------------------------------------------*/
+/**
+ * @brief Decides whether a frame may be sent on the radio link and takes its tokens if so
+ * @param msgClass Class of the message
+ * @param frameBytes Size of the frame on the wire, including framing overhead
+ * @return true if the frame should be sent, false if it must be dropped
+ */
+bool RadioLinkScheduler::Admit(RADIO_MSG_CLASS msgClass, uint16_t frameBytes)
+{
+    SOAR_ASSERT(msgClass < RADIO_MSG_NUM_CLASSES, "RadioLinkScheduler - Invalid message class");
+
+    taskENTER_CRITICAL();
+    Refill(xTaskGetTickCount());
+
+    bool admit;
+    if (msgClass == RADIO_MSG_CLASS_CONTROL)
+        admit = true;
+    else
+        admit = (tokens_ - (int32_t)frameBytes) >= CLASS_RESERVE_BYTES[msgClass];
+
+    if (admit) {
+        tokens_ -= frameBytes;
+        if (tokens_ < -MAX_DEBT_BYTES)
+            tokens_ = -MAX_DEBT_BYTES;
+
+        stats_[msgClass].sentMsgs++;
+        stats_[msgClass].sentBytes += frameBytes;
+    }
+    else {
+        stats_[msgClass].droppedMsgs++;
+        stats_[msgClass].droppedBytes += frameBytes;
+    }
+    taskEXIT_CRITICAL();
+
+    return admit;
+}
+
+/**
+ * @brief Adds the tokens earned since the last refill, must be called inside a critical section
+ * @param now Current tick count
+ */
+void RadioLinkScheduler::Refill(TickType_t now)
+{
+    TickType_t elapsed = now - lastRefillTick_;
+    lastRefillTick_ = now;
+
+    // Long enough to go from max debt to full, also keeps the multiplication below from overflowing
+    const TickType_t maxElapsed = ((MAX_DEBT_BYTES + RADIO_LINK_BUCKET_SIZE_BYTES) * osKernelSysTickFrequency) / rateBytesPerSec_ + 1;
+    if (elapsed > maxElapsed)
+        elapsed = maxElapsed;
+
+    uint32_t earned = elapsed * rateBytesPerSec_ + tokenRemainder_;
+    tokens_ += earned / osKernelSysTickFrequency;
+    tokenRemainder_ = earned % osKernelSysTickFrequency;
+
+    if (tokens_ >= RADIO_LINK_BUCKET_SIZE_BYTES) {
+        tokens_ = RADIO_LINK_BUCKET_SIZE_BYTES;
+        tokenRemainder_ = 0;
+    }
+}
+
+/**
+ * @brief Changes the sustained byte rate of the link
+ * @param bytesPerSec New rate, clamped to at least 1 byte per second
+ */
+void RadioLinkScheduler::SetRate(uint32_t bytesPerSec)
+{
+    taskENTER_CRITICAL();
+    // Bank the tokens earned at the old rate first
+    Refill(xTaskGetTickCount());
+    rateBytesPerSec_ = (bytesPerSec > 0) ? bytesPerSec : 1;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Copies a consistent snapshot of the statistics of one class
+ * @param msgClass Class to get the statistics of
+ * @param stats Output statistics
+ * @return false if msgClass is out of range
+ */
+bool RadioLinkScheduler::GetClassStats(RADIO_MSG_CLASS msgClass, RadioClassStats& stats)
+{
+    if (msgClass >= RADIO_MSG_NUM_CLASSES)
+        return false;
+
+    taskENTER_CRITICAL();
+    stats = stats_[msgClass];
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+/**
+ * @brief Clears the statistics of every class
+ */
+void RadioLinkScheduler::ResetStats()
+{
+    taskENTER_CRITICAL();
+    for (uint8_t i = 0; i < RADIO_MSG_NUM_CLASSES; i++)
+        stats_[i] = {};
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Prints the link budget and the statistics of every class
+ */
+void RadioLinkScheduler::PrintStats()
+{
+    static const char* const classNames[RADIO_MSG_NUM_CLASSES] = { "Control", "State", "SensorHi", "SensorLo" };
+
+    SOAR_PRINT("\n\t-- Radio Link Stats (%d B/s, %d B available) --\n", rateBytesPerSec_, tokens_);
+    for (uint8_t i = 0; i < RADIO_MSG_NUM_CLASSES; i++) {
+        RadioClassStats stats;
+        GetClassStats((RADIO_MSG_CLASS)i, stats);
+        SOAR_PRINT("%-8s: sent %d (%d B), dropped %d (%d B)\n",
+            classNames[i], stats.sentMsgs, stats.sentBytes, stats.droppedMsgs, stats.droppedBytes);
+    }
+    SOAR_PRINT("\n");
+}
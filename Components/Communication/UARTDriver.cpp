@@ -6,7 +6,9 @@
  ******************************************************************************
  *
  * Notes:
- * If further efficiency is required, DMA can be used to transmit and receive.
+ * Transmit uses DMA, the stream is configured at runtime (InitTxDMA) rather than by CubeMX.
+ * ReceiveDMA runs the Rx stream in circular mode and uses the UART IDLE line interrupt plus the DMA half/full
+ * transfer interrupts to hand received data to the receiver in spans.
  * A good reference for this is MaJerle's STM32 USART DMA RX/TX example
  * https://github.com/MaJerle/stm32-usart-uart-dma-rx-tx/blob/main/projects/usart_rx_idle_line_irq_rtos_F4/Src/main.c
  *
@@ -14,13 +16,59 @@
 */
 #include "UARTDriver.hpp"
 #include "main_avionics.hpp"
+#include "stm32f4xx_ll_bus.h"
+#include "Utils.hpp"
 
-// Declare the global UART driver objects
+// Declare the global UART driver objects, Tx and Rx DMA streams are from the RM0090 DMA request mapping tables
 namespace Driver {
-    UARTDriver uart1(USART1);
-    UARTDriver uart2(USART2);
-    UARTDriver uart3(USART3);
-	UARTDriver uart5(UART5);
+    UARTDriver uart1(USART1, { DMA2, LL_DMA_STREAM_7, LL_DMA_CHANNEL_4, DMA2_Stream7_IRQn },
+                             { DMA2, LL_DMA_STREAM_2, LL_DMA_CHANNEL_4, DMA2_Stream2_IRQn });
+    UARTDriver uart2(USART2, { DMA1, LL_DMA_STREAM_6, LL_DMA_CHANNEL_4, DMA1_Stream6_IRQn },
+                             { DMA1, LL_DMA_STREAM_5, LL_DMA_CHANNEL_4, DMA1_Stream5_IRQn });
+    UARTDriver uart3(USART3, { DMA1, LL_DMA_STREAM_3, LL_DMA_CHANNEL_4, DMA1_Stream3_IRQn },
+                             { DMA1, LL_DMA_STREAM_1, LL_DMA_CHANNEL_4, DMA1_Stream1_IRQn });
+    UARTDriver uart5(UART5,  { DMA1, LL_DMA_STREAM_7, LL_DMA_CHANNEL_4, DMA1_Stream7_IRQn },
+                             { DMA1, LL_DMA_STREAM_0, LL_DMA_CHANNEL_4, DMA1_Stream0_IRQn });
+}
+
+/* DMA Helpers ------------------------------------------------------------------*/
+// Bit offset of each stream's flags within the LISR/HISR (and LIFCR/HIFCR) registers
+static constexpr uint8_t DMA_STREAM_FLAG_SHIFT[8] = { 0, 6, 16, 22, 0, 6, 16, 22 };
+
+constexpr uint32_t DMA_FLAG_TC = 0x20;		// Transfer complete
+constexpr uint32_t DMA_FLAG_HT = 0x10;		// Half transfer
+constexpr uint32_t DMA_FLAG_TE = 0x08;		// Transfer error
+constexpr uint32_t DMA_FLAG_ALL = 0x3D;		// TC, HT, TE, DME and FE
+
+/**
+ * @brief Gets the interrupt status flags of a DMA stream, shifted down to the stream 0 positions
+ */
+static inline uint32_t GetDMAStreamFlags(DMA_TypeDef* dma, uint32_t stream)
+{
+	uint32_t isr = (stream < LL_DMA_STREAM_4) ? dma->LISR : dma->HISR;
+	return (isr >> DMA_STREAM_FLAG_SHIFT[stream]) & DMA_FLAG_ALL;
+}
+
+/**
+ * @brief Clears the given interrupt status flags of a DMA stream, flags are in the stream 0 positions
+ */
+static inline void ClearDMAStreamFlags(DMA_TypeDef* dma, uint32_t stream, uint32_t flags)
+{
+	if (stream < LL_DMA_STREAM_4)
+		dma->LIFCR = flags << DMA_STREAM_FLAG_SHIFT[stream];
+	else
+		dma->HIFCR = flags << DMA_STREAM_FLAG_SHIFT[stream];
+}
+
+/**
+ * @brief Enables the clock of a DMA controller
+ */
+static inline void EnableDMAClock(DMA_TypeDef* dma)
+{
+	if (dma == DMA1)
+		LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA1);
+	else
+		LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA2);
 }
 
 /**
@@ -31,6 +79,10 @@ namespace Driver {
  */
 bool UARTDriver::Transmit(uint8_t* data, uint16_t len)
 {
+	// Polling takes over the UART, stop any DMA transfer in progress
+	if (txBusy_)
+		AbortTxDMA();
+
 	// Loop through and transmit each byte via. polling
 	for (uint16_t i = 0; i < len; i++) {
 		LL_USART_TransmitData8(kUart_, data[i]);
@@ -45,6 +97,104 @@ bool UARTDriver::Transmit(uint8_t* data, uint16_t len)
 	return true;
 }
 
+/**
+ * @brief Configures the Tx DMA stream for byte transfers from memory to the UART data register
+ */
+void UARTDriver::InitTxDMA()
+{
+	DMA_TypeDef* dma = kTxDma_.dma;
+	uint32_t stream = kTxDma_.stream;
+
+	EnableDMAClock(dma);
+
+	LL_DMA_DisableStream(dma, stream);
+	while (LL_DMA_IsEnabledStream(dma, stream)) {}
+
+	LL_DMA_SetChannelSelection(dma, stream, kTxDma_.channel);
+	LL_DMA_SetDataTransferDirection(dma, stream, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+	LL_DMA_SetStreamPriorityLevel(dma, stream, LL_DMA_PRIORITY_LOW);
+	LL_DMA_SetMode(dma, stream, LL_DMA_MODE_NORMAL);
+	LL_DMA_SetPeriphIncMode(dma, stream, LL_DMA_PERIPH_NOINCREMENT);
+	LL_DMA_SetMemoryIncMode(dma, stream, LL_DMA_MEMORY_INCREMENT);
+	LL_DMA_SetPeriphSize(dma, stream, LL_DMA_PDATAALIGN_BYTE);
+	LL_DMA_SetMemorySize(dma, stream, LL_DMA_MDATAALIGN_BYTE);
+	LL_DMA_DisableFifoMode(dma, stream);
+	LL_DMA_SetPeriphAddress(dma, stream, LL_USART_DMA_GetRegAddr(kUart_));
+
+	ClearDMAStreamFlags(dma, stream, DMA_FLAG_ALL);
+	LL_DMA_EnableIT_TC(dma, stream);
+	LL_DMA_EnableIT_TE(dma, stream);
+
+	// Same priority as the UART interrupts, must be at or below configMAX_SYSCALL_INTERRUPT_PRIORITY to use FromISR calls
+	NVIC_SetPriority(kTxDma_.irqn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 5, 0));
+	NVIC_EnableIRQ(kTxDma_.irqn);
+}
+
+/**
+ * @brief Starts a DMA transfer and returns immediately, the listener (or calling task) is notified when it completes
+ * @param data The data to transmit, must remain valid (and not in CCM RAM) until the transfer completes
+ * @param len The length of the data to transmit
+ * @param listener Called from the ISR on completion, if nullptr the calling task is notified instead (see WaitTransmitComplete)
+ * @return True if the transfer was started, false if a transfer is already in progress
+ */
+bool UARTDriver::TransmitDMA(const uint8_t* data, uint16_t len, UARTTransmitterBase* listener)
+{
+	if (txBusy_ || len == 0)
+		return false;
+
+	DMA_TypeDef* dma = kTxDma_.dma;
+	uint32_t stream = kTxDma_.stream;
+
+	if (listener == nullptr) {
+		// Discard any notification left over from a transfer that completed after its wait timed out
+		ulTaskNotifyTake(pdTRUE, 0);
+		txNotifyTask_ = xTaskGetCurrentTaskHandle();
+	}
+	else {
+		txNotifyTask_ = nullptr;
+	}
+	txListener_ = listener;
+	txError_ = false;
+	txBusy_ = true;
+
+	ClearDMAStreamFlags(dma, stream, DMA_FLAG_ALL);
+	LL_DMA_SetMemoryAddress(dma, stream, (uint32_t)data);
+	LL_DMA_SetDataLength(dma, stream, len);
+
+	LL_USART_ClearFlag_TC(kUart_);
+	LL_USART_EnableDMAReq_TX(kUart_);
+	LL_DMA_EnableStream(dma, stream);
+
+	return true;
+}
+
+/**
+ * @brief Blocks the calling task (not the CPU) until the transfer started by TransmitDMA completes
+ * @param timeout_ms Maximum time to wait, the transfer is aborted if it has not completed by then
+ * @return True if the transfer completed, false if it timed out or failed
+ */
+bool UARTDriver::WaitTransmitComplete(uint32_t timeout_ms)
+{
+	if (ulTaskNotifyTake(pdTRUE, MS_TO_TICKS(timeout_ms)) > 0 && !txBusy_ && !txError_)
+		return true;
+
+	AbortTxDMA();
+	return false;
+}
+
+/**
+ * @brief Stops the Tx DMA stream and releases the transmitter
+ */
+void UARTDriver::AbortTxDMA()
+{
+	LL_DMA_DisableStream(kTxDma_.dma, kTxDma_.stream);
+	while (LL_DMA_IsEnabledStream(kTxDma_.dma, kTxDma_.stream)) {}
+
+	LL_USART_DisableDMAReq_TX(kUart_);
+	ClearDMAStreamFlags(kTxDma_.dma, kTxDma_.stream, DMA_FLAG_ALL);
+	txBusy_ = false;
+}
+
 /**
 * @brief Receives 1 byte of data via interrupt
 * @param receiver
@@ -68,6 +218,98 @@ bool UARTDriver::ReceiveIT(uint8_t* charBuf, UARTReceiverBase* receiver)
 	return true;
 }
 
+/**
+ * @brief Starts continuous reception into a circular DMA buffer. The receiver is called with the newly
+ *        received span whenever the line goes idle, or the DMA reaches the half or end of the buffer,
+ *        instead of once per byte.
+ * @param buffer Circular buffer, must remain valid while receiving and must not be in CCM RAM
+ * @param size Size of the buffer, should hold at least twice the data received between two idle lines
+ * @param receiver Receiver to pass the received spans to, called from the ISR
+ * @return TRUE if reception was started, FALSE otherwise
+ */
+bool UARTDriver::ReceiveDMA(uint8_t* buffer, uint16_t size, UARTReceiverBase* receiver)
+{
+	if (buffer == nullptr || size == 0)
+		return false;
+
+	DMA_TypeDef* dma = kRxDma_.dma;
+	uint32_t stream = kRxDma_.stream;
+
+	EnableDMAClock(dma);
+
+	// Stop any reception in progress
+	LL_USART_DisableIT_RXNE(kUart_);
+	LL_USART_DisableIT_IDLE(kUart_);
+	LL_USART_DisableDMAReq_RX(kUart_);
+	LL_DMA_DisableStream(dma, stream);
+	while (LL_DMA_IsEnabledStream(dma, stream)) {}
+
+	rxDmaBuf_ = buffer;
+	rxDmaSize_ = size;
+	rxDmaPos_ = 0;
+	rxReceiver_ = receiver;
+
+	LL_DMA_SetChannelSelection(dma, stream, kRxDma_.channel);
+	LL_DMA_SetDataTransferDirection(dma, stream, LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
+	LL_DMA_SetStreamPriorityLevel(dma, stream, LL_DMA_PRIORITY_MEDIUM);
+	LL_DMA_SetMode(dma, stream, LL_DMA_MODE_CIRCULAR);
+	LL_DMA_SetPeriphIncMode(dma, stream, LL_DMA_PERIPH_NOINCREMENT);
+	LL_DMA_SetMemoryIncMode(dma, stream, LL_DMA_MEMORY_INCREMENT);
+	LL_DMA_SetPeriphSize(dma, stream, LL_DMA_PDATAALIGN_BYTE);
+	LL_DMA_SetMemorySize(dma, stream, LL_DMA_MDATAALIGN_BYTE);
+	LL_DMA_DisableFifoMode(dma, stream);
+	LL_DMA_SetPeriphAddress(dma, stream, LL_USART_DMA_GetRegAddr(kUart_));
+	LL_DMA_SetMemoryAddress(dma, stream, (uint32_t)buffer);
+	LL_DMA_SetDataLength(dma, stream, size);
+
+	ClearDMAStreamFlags(dma, stream, DMA_FLAG_ALL);
+	LL_DMA_EnableIT_HT(dma, stream);
+	LL_DMA_EnableIT_TC(dma, stream);
+	LL_DMA_EnableIT_TE(dma, stream);
+
+	NVIC_SetPriority(kRxDma_.irqn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 5, 0));
+	NVIC_EnableIRQ(kRxDma_.irqn);
+
+	// Clear any stale errors and idle flag before starting, then let the line idle interrupt mark the end of each burst
+	HandleAndClearRxError();
+	LL_USART_ClearFlag_IDLE(kUart_);
+	LL_USART_EnableDMAReq_RX(kUart_);
+	LL_DMA_EnableStream(dma, stream);
+	LL_USART_EnableIT_IDLE(kUart_);
+
+	return true;
+}
+
+/**
+ * @brief Passes any data the Rx DMA has written since the last call to the receiver, in at most two spans
+ *        when the data wraps around the end of the buffer
+ * @attention Must only be called from the UART or Rx DMA interrupts, which share a priority and can't preempt each other
+ */
+void UARTDriver::ProcessRxDMA()
+{
+	if (rxDmaBuf_ == nullptr)
+		return;
+
+	// The DMA counts down the remaining transfers, so this is the index it will write next
+	uint16_t pos = rxDmaSize_ - LL_DMA_GetDataLength(kRxDma_.dma, kRxDma_.stream);
+	if (pos == rxDmaPos_)
+		return;
+
+	uint8_t errors = GetRxErrors();
+	if (rxReceiver_ != nullptr) {
+		if (pos > rxDmaPos_) {
+			rxReceiver_->InterruptRxSpan(&rxDmaBuf_[rxDmaPos_], pos - rxDmaPos_, errors);
+		}
+		else {
+			rxReceiver_->InterruptRxSpan(&rxDmaBuf_[rxDmaPos_], rxDmaSize_ - rxDmaPos_, errors);
+			if (pos > 0)
+				rxReceiver_->InterruptRxSpan(rxDmaBuf_, pos, errors);
+		}
+	}
+
+	rxDmaPos_ = (pos == rxDmaSize_) ? 0 : pos;
+}
+
 /**
  * @brief Clears any error flags that may have been set, printing a warning message if necessary
  * @return true if flags had to be cleared, false otherwise
@@ -125,8 +367,15 @@ bool UARTDriver::GetRxErrors()
  */
 void UARTDriver::HandleIRQ_UART()
 {
-	// Call the callback if RXNE is set
-	if (LL_USART_IsActiveFlag_RXNE(kUart_)) {
+	// Line went idle while receiving with DMA, pass the burst to the receiver
+	if (LL_USART_IsEnabledIT_IDLE(kUart_) && LL_USART_IsActiveFlag_IDLE(kUart_)) {
+		LL_USART_ClearFlag_IDLE(kUart_);
+		ProcessRxDMA();
+		HandleAndClearRxError();
+	}
+
+	// Call the callback if RXNE is set, only in interrupt mode as the DMA owns the data register otherwise
+	if (LL_USART_IsEnabledIT_RXNE(kUart_) && LL_USART_IsActiveFlag_RXNE(kUart_)) {
 		// Read the data from the data register
 		if (rxCharBuf_ != nullptr) {
 			*rxCharBuf_ = LL_USART_ReceiveData8(kUart_);
@@ -138,3 +387,50 @@ void UARTDriver::HandleIRQ_UART()
 		}
 	}
 }
+
+/**
+ * @brief Handles the Tx DMA stream interrupt, releases the transmitter and notifies the waiting task
+ * @attention MUST be called inside the DMAx_Streamy_IRQHandler of the Tx stream
+ */
+void UARTDriver::HandleIRQ_TxDMA()
+{
+	uint32_t flags = GetDMAStreamFlags(kTxDma_.dma, kTxDma_.stream);
+	ClearDMAStreamFlags(kTxDma_.dma, kTxDma_.stream, flags);
+
+	if (!(flags & (DMA_FLAG_TC | DMA_FLAG_TE)))
+		return;
+
+	// A transfer error disables the stream in hardware, either way the transmitter is free again
+	LL_USART_DisableDMAReq_TX(kUart_);
+	txError_ = (flags & DMA_FLAG_TE) != 0;
+	txBusy_ = false;
+
+	if (txListener_ != nullptr) {
+		txListener_->InterruptTxComplete(this);
+	}
+	else if (txNotifyTask_ != nullptr) {
+		BaseType_t higherPriorityTaskWoken = pdFALSE;
+		vTaskNotifyGiveFromISR(txNotifyTask_, &higherPriorityTaskWoken);
+		portYIELD_FROM_ISR(higherPriorityTaskWoken);
+	}
+}
+
+/**
+ * @brief Handles the Rx DMA stream interrupt, passes the received data to the receiver on half and full buffer
+ * @attention MUST be called inside the DMAx_Streamy_IRQHandler of the Rx stream
+ */
+void UARTDriver::HandleIRQ_RxDMA()
+{
+	uint32_t flags = GetDMAStreamFlags(kRxDma_.dma, kRxDma_.stream);
+	ClearDMAStreamFlags(kRxDma_.dma, kRxDma_.stream, flags);
+
+	if (flags & (DMA_FLAG_HT | DMA_FLAG_TC))
+		ProcessRxDMA();
+
+	// A transfer error disables the stream, restart it so reception continues
+	if (flags & DMA_FLAG_TE) {
+		rxDmaPos_ = 0;
+		LL_DMA_SetDataLength(kRxDma_.dma, kRxDma_.stream, rxDmaSize_);
+		LL_DMA_EnableStream(kRxDma_.dma, kRxDma_.stream);
+	}
+}
@@ -7,15 +7,62 @@
 
 #include "UARTTask.hpp"
 #include "UARTDriver.hpp"
+#include "Utils.hpp"
+
+#include <cstring>
+
+/* Static Variable Init ------------------------------------------------------------------*/
+UARTTask UARTTask::inst_;
+
+/**
+ * @brief Constructor, assigns each channel its UART and transmit queue
+ *
+ * Debug and radio output keeps the newest data when a channel backs up, PBB keeps the oldest so queued
+ * commands to the PBB are sent in order. No channel queue ever blocks the task.
+ * Radio frames are COBS encoded with a 0x00 delimiter, so they can be packed back to back into one burst
+ * and still be split apart by the ground station.
+*/
+UARTTask::UARTTask() : Task(&evtQueue_)
+{
+    channels_[UART_TASK_CHANNEL_DEBUG].uart = UART::Debug;
+    channels_[UART_TASK_CHANNEL_DEBUG].queue = &debugTxQueue_;
+    channels_[UART_TASK_CHANNEL_RADIO].uart = UART::Radio;
+    channels_[UART_TASK_CHANNEL_RADIO].queue = &radioTxQueue_;
+    channels_[UART_TASK_CHANNEL_PBB].uart = UART::Conduit_PBB;
+    channels_[UART_TASK_CHANNEL_PBB].queue = &pbbTxQueue_;
+
+    debugTxQueue_.SetSendPolicy(QUEUE_SEND_DROP_OLDEST);
+    radioTxQueue_.SetSendPolicy(QUEUE_SEND_DROP_OLDEST);
+    pbbTxQueue_.SetSendPolicy(QUEUE_SEND_DROP_NEWEST);
+
+    for (uint8_t i = 0; i < UART_TASK_NUM_CHANNELS; i++) {
+        channels_[i].busy = false;
+        channels_[i].burstInFlight = false;
+        channels_[i].inFlightHeld = false;
+        channels_[i].startTick = 0;
+        channels_[i].transferFrames = 0;
+        channels_[i].transferBytes = 0;
+        channels_[i].burstBuffer = nullptr;
+        channels_[i].burstBufferSize = 0;
+        channels_[i].windowTicks = 0;
+        channels_[i].pending = false;
+        channels_[i].pendingTick = 0;
+        channels_[i].stats = {};
+    }
+
+    channels_[UART_TASK_CHANNEL_RADIO].burstBuffer = radioBurstBuffer_;
+    channels_[UART_TASK_CHANNEL_RADIO].burstBufferSize = sizeof(radioBurstBuffer_);
+    channels_[UART_TASK_CHANNEL_RADIO].windowTicks = MS_TO_TICKS(UART_TASK_RADIO_AGGREGATION_WINDOW_MS);
+}
 
 /**
- * TODO: Currently not used, would be used for DMA buffer configuration or interrupt setup
- * @brief Configures UART DMA buffers and interrupts
- * 
+ * @brief Configures the Tx DMA streams of every UART this task transmits on
 */
 void UARTTask::ConfigureUART()
 {
-    // UART 5 - Uses polling for now (switch to DMA or interrupts once SOAR-Protocol is defined)
+    UART::Debug->InitTxDMA();
+    UART::Radio->InitTxDMA();
+    UART::Conduit_PBB->InitTxDMA();
 }
 
 /**
@@ -27,36 +74,45 @@ void UARTTask::InitTask()
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize UART task twice");
     
     // Start the task
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)UARTTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)UARTTask::RunTask,
             (const char*)"UARTTask",
-            (uint16_t)UART_TASK_STACK_DEPTH_WORDS,
+            (uint32_t)UART_TASK_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)UART_TASK_RTOS_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
     //Ensure creation succeded
-    SOAR_ASSERT(rtValue == pdPASS, "UARTTask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "UARTTask::InitTask() - xTaskCreateStatic() failed");
 
     // Configure DMA
-     
+    ConfigureUART();
 }
 
 /**
  * @brief Instance Run loop for the UART Task, runs on scheduler start as long as the task is initialized.
+ *        Incoming commands are sorted into the channel queues, then every idle channel starts its next DMA transfer.
+ *        The task never waits on a transfer, so the channels transmit concurrently.
  * @param pvParams RTOS Passed void parameters, contains a pointer to the object instance, should not be used
 */
 void UARTTask::Run(void * pvParams)
 {
-    //UART Task loop
-    while(1) {
-        Command cm;
-
-        //Wait forever for a command
-        qEvtQueue->ReceiveWait(cm);
-        
-        //Process the command
-        HandleCommand(cm);
+    Command batch[MAX_COMMAND_BATCH_SIZE];
+
+    while (1) {
+        // Wake up for the next aggregation window to close, or to catch a transfer that never completes
+        uint16_t count;
+        TickType_t waitTicks = GetWaitTicks();
+        if (waitTicks == portMAX_DELAY)
+            count = qEvtQueue->ReceiveBatchWait(batch, MAX_COMMAND_BATCH_SIZE);
+        else
+            count = qEvtQueue->ReceiveBatch(batch, MAX_COMMAND_BATCH_SIZE, TICKS_TO_MS(waitTicks));
+
+        if (count > 0)
+            HandleCommandBatch(batch, count);
+
+        ServiceChannels();
     }
 }
 
@@ -70,26 +126,25 @@ void UARTTask::HandleCommand(Command& cm)
     //Switch for the GLOBAL_COMMAND
     switch (cm.GetCommand()) {
     case DATA_COMMAND: {
-        //Switch for task specific command within DATA_COMMAND
+        //Switch for task specific command within DATA_COMMAND, the channel queue takes ownership of the data
         switch (cm.GetTaskCommand()) {
         case UART_TASK_COMMAND_SEND_DEBUG:
-            UART::Debug->Transmit(cm.GetDataPointer(), cm.GetDataSize());
-            osDelay(1);
-            break;
+            QueueTransmit(UART_TASK_CHANNEL_DEBUG, cm);
+            return;
         case UART_TASK_COMMAND_SEND_RADIO:
-            UART::Radio->Transmit(cm.GetDataPointer(), cm.GetDataSize());
-            osDelay(1);
-        	break;
+            QueueTransmit(UART_TASK_CHANNEL_RADIO, cm);
+            return;
         case UART_TASK_COMMAND_SEND_PBB:
-            UART::Conduit_PBB->Transmit(cm.GetDataPointer(), cm.GetDataSize());
-            osDelay(1);
-            break;
+            QueueTransmit(UART_TASK_CHANNEL_PBB, cm);
+            return;
         default:
             SOAR_PRINT("UARTTask - Received Unsupported DATA_COMMAND {%d}\n", cm.GetTaskCommand());
             break;
         }
+        break;
     }
     case TASK_SPECIFIC_COMMAND: {
+        // UART_TASK_EVENT_TX_COMPLETE only wakes the task, the channels are serviced after every batch
         break;
     }
     default:
@@ -100,3 +155,204 @@ void UARTTask::HandleCommand(Command& cm)
     //No matter what we happens, we must reset allocated data
     cm.Reset();
 }
+
+/**
+ * @brief Called from the Tx DMA ISR when a channel transfer finishes, wakes the task to start the next one
+ * @param uart UART whose transfer finished
+*/
+void UARTTask::InterruptTxComplete(UARTDriver* uart)
+{
+    Command cm(TASK_SPECIFIC_COMMAND, UART_TASK_EVENT_TX_COMPLETE);
+    qEvtQueue->SendPriorityFromISR(cm);
+}
+
+/**
+ * @brief Moves a command into a channel transmit queue using the queue send policy, drops are counted rather than waited on
+ * @param channel Channel to transmit on
+ * @param cm Command holding the data, ownership passes to the channel
+*/
+void UARTTask::QueueTransmit(UART_TASK_CHANNEL channel, Command& cm)
+{
+    TxChannel& ch = channels_[channel];
+
+    QUEUE_SEND_RESULT res = ch.queue->SendWithPolicy(cm, ch.queue->GetSendPolicy());
+    if (res == QUEUE_SEND_FULL)
+        cm.Reset();
+
+    if (res != QUEUE_SEND_OK)
+        ch.stats.framesDropped++;
+
+    // Start the aggregation window with the oldest frame
+    if (res != QUEUE_SEND_DROPPED && res != QUEUE_SEND_FULL && !ch.pending) {
+        ch.pending = true;
+        ch.pendingTick = xTaskGetTickCount();
+    }
+}
+
+/**
+ * @brief Retires finished (or timed out) transfers and starts the next queued transfer on every idle channel
+*/
+void UARTTask::ServiceChannels()
+{
+    for (uint8_t i = 0; i < UART_TASK_NUM_CHANNELS; i++) {
+        TxChannel& ch = channels_[i];
+
+        if (ch.busy) {
+            if (!ch.uart->IsTransmitBusy()) {
+                FinishTransmit(ch, !ch.uart->LastTransmitFailed());
+            }
+            else if ((xTaskGetTickCount() - ch.startTick) >= MS_TO_TICKS(UART_TASK_TX_DMA_TIMEOUT_MS)) {
+                ch.uart->AbortTxDMA();
+                FinishTransmit(ch, false);
+            }
+        }
+
+        if (!ch.busy) {
+            if (ch.burstBuffer != nullptr)
+                StartBurst(ch);
+            else
+                StartTransmit(ch);
+        }
+    }
+}
+
+/**
+ * @brief Updates the channel statistics for the transfer in progress and releases it
+ * @param ch Channel whose transfer has finished
+ * @param success True if the transfer completed without error
+*/
+void UARTTask::FinishTransmit(TxChannel& ch, bool success)
+{
+    if (success) {
+        ch.stats.framesSent += ch.transferFrames;
+        ch.stats.bytesSent += ch.transferBytes;
+    }
+    else {
+        ch.stats.framesFailed += ch.transferFrames;
+    }
+
+    // A burst leaves inFlight alone, it may hold the frame that did not fit
+    if (!ch.burstInFlight) {
+        ch.inFlight.Reset();
+        ch.inFlightHeld = false;
+    }
+
+    ch.busy = false;
+    ch.burstInFlight = false;
+}
+
+/**
+ * @brief Starts a transfer of the next queued command, the DMA reads straight from the in flight command
+ * @param ch Idle channel to start the transfer on
+*/
+void UARTTask::StartTransmit(TxChannel& ch)
+{
+    while (!ch.busy && (ch.inFlightHeld || ch.queue->Receive(ch.inFlight))) {
+        ch.inFlightHeld = true;
+        ch.transferFrames = 1;
+        ch.transferBytes = ch.inFlight.GetDataSize();
+        ch.startTick = xTaskGetTickCount();
+        ch.busy = ch.uart->TransmitDMA(ch.inFlight.GetDataPointer(), ch.transferBytes, this);
+        if (!ch.busy) {
+            ch.inFlight.Reset();
+            ch.inFlightHeld = false;
+        }
+        else {
+            ch.stats.transfers++;
+        }
+    }
+
+    if (!ch.busy)
+        ch.pending = false;
+}
+
+/**
+ * @brief Packs every queued frame that fits into the burst buffer and sends them as one transfer. Waits until the
+ *        oldest frame has been queued for the aggregation window, unless the queue is already full.
+ * @param ch Idle channel with a burst buffer to start the burst on
+*/
+void UARTTask::StartBurst(TxChannel& ch)
+{
+    if (!ch.pending)
+        return;
+
+    bool queueFull = ch.queue->GetQueueMessageCount() >= ch.queue->GetQueueDepth();
+    if (!queueFull && (xTaskGetTickCount() - ch.pendingTick) < ch.windowTicks)
+        return;
+
+    // inFlight is used as the receive slot, a frame that does not fit stays there for the next burst
+    uint16_t len = 0;
+    uint16_t frames = 0;
+    while (ch.inFlightHeld || ch.queue->Receive(ch.inFlight)) {
+        ch.inFlightHeld = true;
+        uint16_t size = ch.inFlight.GetDataSize();
+        if (len + size > ch.burstBufferSize)
+            break;
+
+        memcpy(&ch.burstBuffer[len], ch.inFlight.GetDataPointer(), size);
+        len += size;
+        frames++;
+        ch.inFlight.Reset();
+        ch.inFlightHeld = false;
+    }
+
+    // A frame larger than the burst buffer is sent on its own
+    if (len == 0) {
+        StartTransmit(ch);
+        return;
+    }
+
+    ch.transferFrames = frames;
+    ch.transferBytes = len;
+    ch.startTick = xTaskGetTickCount();
+    ch.burstInFlight = ch.uart->TransmitDMA(ch.burstBuffer, len, this);
+    ch.busy = ch.burstInFlight;
+    if (ch.busy)
+        ch.stats.transfers++;
+    else
+        ch.stats.framesFailed += frames;
+
+    // Frames left behind have already waited a full window, they go out as soon as this burst completes
+    if (!ch.inFlightHeld && ch.queue->GetQueueMessageCount() == 0)
+        ch.pending = false;
+}
+
+/**
+ * @brief Gets how long the task may block before a channel needs servicing, portMAX_DELAY if nothing is waiting
+*/
+TickType_t UARTTask::GetWaitTicks() const
+{
+    TickType_t waitTicks = portMAX_DELAY;
+    TickType_t now = xTaskGetTickCount();
+
+    for (uint8_t i = 0; i < UART_TASK_NUM_CHANNELS; i++) {
+        const TxChannel& ch = channels_[i];
+        TickType_t chWait = portMAX_DELAY;
+
+        if (ch.busy) {
+            chWait = MS_TO_TICKS(UART_TASK_TX_DMA_TIMEOUT_MS);
+        }
+        else if (ch.pending) {
+            TickType_t elapsed = now - ch.pendingTick;
+            chWait = (elapsed >= ch.windowTicks) ? 0 : ch.windowTicks - elapsed;
+        }
+
+        if (chWait < waitTicks)
+            waitTicks = chWait;
+    }
+
+    return waitTicks;
+}
+
+/**
+ * @brief Copies a consistent snapshot of a channel's transmit statistics
+ * @param channel Channel to get the statistics of
+ * @param stats Output statistics
+*/
+void UARTTask::GetChannelStats(UART_TASK_CHANNEL channel, UARTChannelStats& stats) const
+{
+    // The counters are only written by this task, so holding off the scheduler is enough
+    taskENTER_CRITICAL();
+    stats = channels_[channel].stats;
+    taskEXIT_CRITICAL();
+}
@@ -10,14 +10,10 @@
 */
 #include "Command.hpp"
 #include "SystemDefines.hpp"
+#include "MemoryPool.hpp"
 
 #include <cstring>     // Support for memcpy
 
-/* Static Variable Init ------------------------------------------------------------------*/
-std::atomic<uint16_t> Command::statAllocationCounter; // Static variable init
-
-
-
 /* Function Implementation ------------------------------------------------------------------*/
 
 /**
@@ -29,7 +25,8 @@ Command::Command(void)
     taskCommand = 0;
     data = nullptr;
     dataSize = 0;
-    bShouldFreeData = false;
+    dataStorage = COMMAND_DATA_NONE;
+    enqueueTick = 0;
 }
 
 /**
@@ -42,7 +39,8 @@ Command::Command(GLOBAL_COMMANDS command)
     taskCommand = 0;
     data = nullptr;
     dataSize = 0;
-    bShouldFreeData = false;
+    dataStorage = COMMAND_DATA_NONE;
+    enqueueTick = 0;
 }
 
 /**
@@ -55,7 +53,8 @@ Command::Command(uint16_t taskCommand)
     this->taskCommand = taskCommand;
     data = nullptr;
     dataSize = 0;
-    bShouldFreeData = false;
+    dataStorage = COMMAND_DATA_NONE;
+    enqueueTick = 0;
 }
 
 /**
@@ -69,7 +68,8 @@ Command::Command(GLOBAL_COMMANDS command, uint16_t taskCommand)
     this->taskCommand = taskCommand;
     data = nullptr;
     dataSize = 0;
-    bShouldFreeData = false;
+    dataStorage = COMMAND_DATA_NONE;
+    enqueueTick = 0;
 }
 
 // We cannot use a Destructor, it would get destroyed at lifetime end
@@ -81,24 +81,34 @@ Command::Command(GLOBAL_COMMANDS command, uint16_t taskCommand)
 //}
 
 /**
- * @brief Dynamically allocates memory for the command with the given data size
+ * @brief Allocates memory for the command with the given data size. Payloads up to COMMAND_INLINE_DATA_SIZE_BYTES
+ *        are stored inside the Command, larger payloads are allocated from the command memory pool.
+ *        Note the returned pointer for inline data is only valid for this Command object, not for copies of it.
  * @param dataSize Size of array to allocate
- * @return Pointer to data on success, nullptr on failure (mem already allocated)
+ * @return Pointer to data on success, nullptr on failure (mem already allocated, or pool exhausted inside an ISR)
 */
 uint8_t* Command::AllocateData(uint16_t dataSize)
 {
     // If we don't have anything allocated, allocate and return success
-    if (this->data == nullptr && !bShouldFreeData) {
-        this->data = soar_malloc(dataSize);
-        this->bShouldFreeData = true;
-        this->dataSize = dataSize;
-        statAllocationCounter += 1;
+    if (dataStorage != COMMAND_DATA_NONE)
+        return nullptr;
 
-        //TODO: May want to print out whenever we have an imbalance in statAllocationCounter by more than ~5 or so.
-        SOAR_ASSERT(statAllocationCounter < MAX_NUMBER_OF_COMMAND_ALLOCATIONS);
-        return this->data;
+    if (dataSize <= COMMAND_INLINE_DATA_SIZE_BYTES) {
+        this->dataStorage = COMMAND_DATA_INLINE;
+        this->dataSize = dataSize;
+        return this->inlineData;
     }
-    return nullptr;
+
+    this->data = MemoryPool::Allocate(dataSize);
+    if (this->data == nullptr)
+        return nullptr;
+
+    // A pool block may be larger than requested, heap fallback memory is exactly the requested size
+    uint16_t blockSize = MemoryPool::GetBlockSize(this->data);
+    this->dataCapacity = (blockSize != 0) ? blockSize : dataSize;
+    this->dataStorage = COMMAND_DATA_POOL;
+    this->dataSize = dataSize;
+    return this->data;
 }
 
 /**
@@ -113,9 +123,10 @@ uint8_t* Command::AllocateData(uint16_t dataSize)
 bool Command::SetCommandToStaticExternalBuffer(uint8_t* existingPtr, uint16_t size)
 {
     // If we don't have anything allocated, set it and return success
-    if(this->data == nullptr) {
+    if(dataStorage == COMMAND_DATA_NONE) {
         this->data = existingPtr;
-        this->bShouldFreeData = false;
+        this->dataCapacity = size;
+        this->dataStorage = COMMAND_DATA_EXTERNAL;
         this->dataSize = size;
         return true;
     }
@@ -128,9 +139,9 @@ bool Command::SetCommandToStaticExternalBuffer(uint8_t* existingPtr, uint16_t si
 bool Command::CopyDataToCommand(uint8_t* dataSrc, uint16_t size)
 {
     // If we successfully allocate, copy the data and return success
-    if(this->AllocateData(size)
-        && this->data != nullptr) {
-        memcpy(this->data, dataSrc, size);
+    uint8_t* dest = this->AllocateData(size);
+    if(dest != nullptr) {
+        memcpy(dest, dataSrc, size);
         return true;
     }
 
@@ -138,16 +149,45 @@ bool Command::CopyDataToCommand(uint8_t* dataSrc, uint16_t size)
 }
 
 /**
- * @brief Resets command, equivalent of a destructor that must be called, counts allocations and deallocations, asserts an error if the allocation count is too high
+ * @brief Resets command, equivalent of a destructor that must be called, returns any owned data to the command memory pool
 */
 void Command::Reset()
 {
-    if(bShouldFreeData && data != nullptr) {
-        soar_free(data);
-        statAllocationCounter -= 1;
-		data = nullptr;
-        bShouldFreeData = false;
+    if(dataStorage == COMMAND_DATA_POOL) {
+        MemoryPool::Free(data);
     }
+
+    data = nullptr;
+    dataSize = 0;
+    dataStorage = COMMAND_DATA_NONE;
+    enqueueTick = 0;
+}
+
+/**
+ * @brief Changes the size of the data already attached to the command, eg. to trim a buffer that was only partly filled.
+ *        The size is bounded by the storage behind the data: the inline buffer, the allocated pool block, or the
+ *        size the external buffer was attached with.
+ * @param size New data size in bytes
+ * @return TRUE on success, FALSE on failure (no data attached, or size exceeds the storage capacity)
+*/
+bool Command::SetDataSize(uint16_t size)
+{
+    switch (dataStorage) {
+    case COMMAND_DATA_INLINE:
+        if (size > sizeof(inlineData))
+            return false;
+        break;
+    case COMMAND_DATA_EXTERNAL:
+    case COMMAND_DATA_POOL:
+        if (size > dataCapacity)
+            return false;
+        break;
+    default:
+        return false;
+    }
+
+    dataSize = size;
+    return true;
 }
 
 /**
@@ -156,7 +196,7 @@ void Command::Reset()
 */
 uint16_t Command::GetDataSize() const
 {
-    if (data == nullptr)
+    if (dataStorage == COMMAND_DATA_NONE)
         return 0;
     return dataSize;
 }
@@ -8,9 +8,8 @@
 #ifndef AVIONICS_INCLUDE_SOAR_CORE_COMMAND_H
 #define AVIONICS_INCLUDE_SOAR_CORE_COMMAND_H
 /* Includes ------------------------------------------------------------------*/
-#include <atomic>
-
 #include "cmsis_os.h"
+#include "SystemDefines.hpp"
 
 /* Macros --------------------------------------------------------------------*/
 
@@ -48,35 +47,51 @@ public:
     //~Command();    // We can't handle memory like this, since the object would be 'destroyed' after copying to the RTOS queue
 
     // Functions
-    uint8_t* AllocateData(uint16_t dataSize);    // Dynamically allocates data for the command
+    uint8_t* AllocateData(uint16_t dataSize);    // Allocates data for the command, stored inline if it fits, otherwise from the command memory pool
     bool CopyDataToCommand(uint8_t* dataSrc, uint16_t size);    // Copies the data into the command, into newly allocated memory
     bool SetCommandToStaticExternalBuffer(uint8_t* existingPtr, uint16_t size);    // Set data pointer to a pre-allocated buffer, if bFreeMemory is set to true, responsibility for freeing memory will fall on Command
 
-    void Reset();    // Reset the command, equivalent of a destructor that must be called, counts allocations and deallocations, asserts an error if the allocation count is too high
+    void Reset();    // Reset the command, equivalent of a destructor that must be called, returns allocated data to the memory pool
 
     // Getters
     uint16_t GetDataSize() const;
-    uint8_t* GetDataPointer() const { return data; }
+    uint8_t* GetDataPointer() const { return (dataStorage == COMMAND_DATA_INLINE) ? const_cast<uint8_t*>(inlineData) : data; }
     GLOBAL_COMMANDS GetCommand() const { return command; }
     uint16_t GetTaskCommand() const { return taskCommand; }
 
     // Setters
     void SetTaskCommand(uint16_t taskCommand) { this->taskCommand = taskCommand; }
-    void SetDataSize(uint16_t size) { dataSize = size; }
+    bool SetDataSize(uint16_t size);    // Changes the size of the attached data, fails if the size exceeds the storage behind it
 
 
 protected:
+    // Where the optional data lives
+    enum COMMAND_DATA_STORAGE : uint8_t
+    {
+        COMMAND_DATA_NONE = 0,      // No data
+        COMMAND_DATA_EXTERNAL,      // Data points to an external buffer that the Command does not own
+        COMMAND_DATA_POOL,          // Data was allocated from the memory pool and is freed on Reset()
+        COMMAND_DATA_INLINE,        // Data is stored inside the Command object itself
+    };
+
     // Data -- note each insertion and removal from a queue will do a full copy of this object, so this data should be as small as possible
     GLOBAL_COMMANDS command;    // General GLOBAL command, each task must be able to handle these types of commands
+    COMMAND_DATA_STORAGE dataStorage;    // Where the optional data lives, decides how the data is accessed and released
     uint16_t taskCommand;        // Task specific command, the task this command event is sent to needs to handle this
-
-    uint8_t* data;                // Pointer to optional data
     uint16_t dataSize;            // Size of optional data
+    uint16_t enqueueTick;        // Low 16 bits of the tick count when last sent to a Queue, used for latency stats (fills padding, no size cost)
 
-private:
-    bool bShouldFreeData;        // Should the Command handle freeing the data pointer (necessary to enable Command object to handle static memory ptrs)
+    // Optional data, small payloads are stored inline so they are copied along with the Command and need no allocation
+    union {
+        struct {
+            uint8_t* data;            // Pointer to optional data (external or pool)
+            uint16_t dataCapacity;    // Number of bytes available at data, bounds SetDataSize
+        };
+        uint8_t inlineData[COMMAND_INLINE_DATA_SIZE_BYTES];    // Inline storage for small payloads
+    };
 
-    static std::atomic<uint16_t> statAllocationCounter;    // Static allocation counter shared by all command objects
+private:
+    friend class Queue;         // Queue stamps enqueueTick
 
     Command(const Command&);    // Prevent copy-construction
 };
@@ -0,0 +1,83 @@
+/**
+ ******************************************************************************
+ * File Name          : MemoryPool.hpp
+ * Description        : Fixed-block, size-class memory pool used for Command payloads.
+ *    Allocation and free are O(1) and safe to call from both tasks and ISRs.
+ ******************************************************************************
+*/
+#ifndef AVIONICS_INCLUDE_SOAR_CORE_MEMORY_POOL_H
+#define AVIONICS_INCLUDE_SOAR_CORE_MEMORY_POOL_H
+/* Includes ------------------------------------------------------------------*/
+#include "cmsis_os.h"
+
+/* Structs -------------------------------------------------------------------*/
+struct MemoryPoolStats
+{
+    uint16_t blockSize;          // Size of each block in this class in bytes
+    uint16_t numBlocks;          // Total number of blocks in this class
+    uint16_t inUse;              // Number of blocks currently allocated
+    uint16_t highWatermark;      // Highest number of blocks ever allocated at once
+    uint32_t exhaustionCount;    // Number of allocations that found this class empty
+};
+
+/* Class -----------------------------------------------------------------*/
+/**
+ * @brief Fixed-block pool over an externally provided, statically sized storage area.
+ *
+ * Blocks that have never been used are handed out from a bump index, freed blocks are kept
+ * on an intrusive free list, so the pool needs no initialization loop and can be constant-initialized.
+ */
+class BlockPool
+{
+public:
+    constexpr BlockPool(uint8_t* storage, uint16_t blockSize, uint16_t numBlocks)
+        : storage_(storage), freeList_(nullptr), blockSize_(blockSize), numBlocks_(numBlocks),
+          numUntouched_(numBlocks), inUse_(0), highWatermark_(0), exhaustionCount_(0) {}
+
+    uint8_t* Allocate();                // Allocates a block, returns nullptr if the pool is exhausted
+    void Free(uint8_t* block);          // Returns a block to the pool, block must be owned by this pool
+    bool Owns(const uint8_t* ptr) const { return ptr >= storage_ && ptr < storage_ + (uint32_t)blockSize_ * numBlocks_; }
+
+    uint16_t GetBlockSize() const { return blockSize_; }
+    void GetStats(MemoryPoolStats& stats) const;
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+    uint8_t* const storage_;        // Start of the storage area, must be aligned for FreeBlock
+    FreeBlock* freeList_;           // Singly linked list of freed blocks
+    const uint16_t blockSize_;      // Size of each block in bytes
+    const uint16_t numBlocks_;      // Number of blocks in the storage area
+    uint16_t numUntouched_;         // Number of blocks at the end of storage that have never been allocated
+
+    uint16_t inUse_;                // Number of blocks currently allocated
+    uint16_t highWatermark_;        // Highest value inUse_ has reached
+    uint32_t exhaustionCount_;      // Number of times an allocation found the pool empty
+};
+
+/**
+ * @brief Size-class allocator for Command payloads.
+ *
+ * Requests are served from the smallest class that fits, falling through to larger classes if a class is exhausted.
+ * Requests larger than the largest class, or made while every fitting class is exhausted, fall back to the RTOS heap.
+ */
+class MemoryPool
+{
+public:
+    static uint8_t* Allocate(uint16_t size);    // Allocates at least size bytes, asserts on failure
+    static void Free(uint8_t* ptr);             // Frees memory returned by Allocate
+    static uint16_t GetBlockSize(const uint8_t* ptr);    // Size of the pool block holding ptr, 0 for heap fallback memory
+
+    static uint8_t GetNumClasses();
+    static bool GetClassStats(uint8_t classIdx, MemoryPoolStats& stats);
+    static uint16_t GetHeapFallbackInUse() { return heapFallbackInUse_; }
+    static uint32_t GetHeapFallbackCount() { return heapFallbackCount_; }
+
+    static void PrintStats();    // Prints per-class statistics over the debug UART
+
+private:
+    static uint16_t heapFallbackInUse_;    // Number of outstanding heap fallback allocations
+    static uint32_t heapFallbackCount_;    // Total number of heap fallback allocations
+};
+
+#endif /* AVIONICS_INCLUDE_SOAR_CORE_MEMORY_POOL_H */
@@ -33,6 +33,7 @@ public:
 
 private:
     SemaphoreHandle_t rtSemaphoreHandle;
+    StaticSemaphore_t rtSemaphoreBuffer;    // Storage for the RTOS mutex structure
 
 };
 
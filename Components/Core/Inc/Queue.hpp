@@ -8,6 +8,18 @@
  *
  *    Currently only handles Command objects, may want to make this a base template
  *    class for which CommandQueue inherits from.
+ *
+ *    StaticQueue<DEPTH, PRIORITY_DEPTH> holds the queue storage in the object itself,
+ *    so a queue that is a member of a statically allocated object needs no heap.
+ *
+ *    A queue can optionally have a second, high priority lane. A counting semaphore
+ *    tracks the items in both lanes so a receiver blocks on one object, and every
+ *    receive drains the priority lane first.
+ *
+ *    Ownership: a command that was queued belongs to the receiver, which must Reset() it.
+ *    Every send that fails resets the command, so its data is never leaked. The only
+ *    exception is SendWithPolicy(cm, QUEUE_SEND_FAIL), which returns QUEUE_SEND_FULL and
+ *    leaves the command with the caller to retry or Reset().
  ******************************************************************************
 */
 #ifndef AVIONICS_INCLUDE_SOAR_CORE_QUEUE_H
@@ -16,6 +28,7 @@
 #include "cmsis_os.h"
 #include "Command.hpp"
 #include "FreeRTOS.h"
+#include "semphr.h"
 #include "Utils.hpp"
 
 /* Macros --------------------------------------------------------------------*/
@@ -24,33 +37,128 @@
 /* Constants -----------------------------------------------------------------*/
 //constexpr uint16_t MAX_TICKS_TO_WAIT_SEND = MS_TO_TICKS(1000);
 
+/* Enums -----------------------------------------------------------------*/
+enum QUEUE_SEND_POLICY : uint8_t
+{
+    QUEUE_SEND_BLOCK = 0,       // Wait up to DEFAULT_QUEUE_SEND_WAIT_TICKS for space, then drop the command
+    QUEUE_SEND_FAIL,            // Return immediately when full. Per call the caller keeps the command, as the Send() default it is reset
+    QUEUE_SEND_DROP_OLDEST,     // Discard the oldest queued command to make space, use when only the latest data matters
+    QUEUE_SEND_DROP_NEWEST,     // Discard the command being sent when full, without waiting. Use per call for periodic samples and requests,
+                                // the next period sends fresh ones, so a busy consumer (eg. flash erasing) never stalls the producer
+};
+
+enum QUEUE_SEND_RESULT : uint8_t
+{
+    QUEUE_SEND_OK = 0,              // Command was queued
+    QUEUE_SEND_OK_DROPPED_OLDEST,   // Command was queued, an older command was discarded to make space
+    QUEUE_SEND_DROPPED,             // Command was discarded and reset
+    QUEUE_SEND_FULL,                // Command was not queued (QUEUE_SEND_FAIL per call), the caller still owns it
+};
+
+/* Structs ---------------------------------------------------------------*/
+struct QueueStats
+{
+    uint32_t sendCount;            // Commands successfully sent to the queue (both lanes)
+    uint32_t failedSendCount;      // Commands not queued because the queue was full
+    uint32_t droppedOldestCount;   // Queued commands discarded to make space for a newer command
+    uint32_t coalescedCount;       // Commands merged into an earlier identical command
+    uint16_t depthHighWatermark;   // Highest number of commands waiting at once (both lanes)
+    uint32_t latencyHistogram[QUEUE_LATENCY_HISTOGRAM_BINS];    // Enqueue to dequeue latency, bin 0 is 0 ticks, bin N is [2^(N-1), 2^N) ticks, the last bin is open ended
+};
+
 /* Class -----------------------------------------------------------------*/
 
 class Queue {
 public:
+    typedef bool (*CoalescePredicate)(const Command& cm);    // Returns true if duplicates of the command may be merged
+
     //Constructors
     Queue(void);
     Queue(uint16_t depth);
+    Queue(uint16_t depth, uint16_t priorityDepth);    // Adds a high priority lane that is always drained before the normal lane
+
+    //Coalescing, merges duplicate idempotent commands found in a batch so they are handled only once
+    void EnableCoalescing(CoalescePredicate isIdempotent = IsDataFreeRequest);
+    static bool IsDataFreeRequest(const Command& cm);    // Default predicate, any REQUEST_COMMAND without data
+
+    //Send policy, the default policy is used by Send(), QUEUE_SEND_BLOCK unless changed
+    void SetSendPolicy(QUEUE_SEND_POLICY policy) { sendPolicy = policy; }
+    QUEUE_SEND_POLICY GetSendPolicy() const { return sendPolicy; }
 
     //Functions
     bool Send(Command& command);
+    QUEUE_SEND_RESULT SendWithPolicy(Command& command, QUEUE_SEND_POLICY policy);    // Sends to the back of the normal lane, result reports backpressure
     bool SendFromISR(Command& command);
 
     bool SendToFront(Command& command);
 
+    bool SendPriority(Command& command);    // Sends to the high priority lane, falls back to SendToFront() if the queue has no priority lane
+    bool SendPriorityFromISR(Command& command);
+
     bool Receive(Command& cm, uint32_t timeout_ms = 0);
     bool ReceiveWait(Command& cm); //Blocks until a command is received
 
+    uint16_t ReceiveBatch(Command* out, uint16_t maxCount, uint32_t timeout_ms = 0); // Blocks for the first command, then drains up to maxCount without blocking
+    uint16_t ReceiveBatchWait(Command* out, uint16_t maxCount); // Blocks forever for the first command, then drains up to maxCount without blocking
+
     //Getters
-    uint16_t GetQueueMessageCount() const { return uxQueueMessagesWaiting(rtQueueHandle); }
+    uint16_t GetQueueMessageCount() const;
     uint16_t GetQueueDepth() const { return queueDepth; }
+    uint16_t GetPriorityQueueDepth() const { return priorityQueueDepth; }
+    uint32_t GetCoalescedCount() const { return stats.coalescedCount; }
+    void GetStats(QueueStats& out) const;    // Copies a consistent snapshot of the queue statistics
+    void ResetStats();
 
 protected:
+    // Uses the given storage instead of the heap when queueStorage is not nullptr, see StaticQueue
+    Queue(uint16_t depth, uint16_t priorityDepth, uint8_t* queueStorage, StaticQueue_t* queueBuffer,
+        uint8_t* priorityQueueStorage, StaticQueue_t* priorityQueueBuffer, StaticSemaphore_t* itemCountSemaphoreBuffer);
+
+    bool ReceiveTicks(Command& cm, TickType_t timeoutTicks);
+    uint16_t ReceiveBatchTicks(Command* out, uint16_t maxCount, TickType_t timeoutTicks);
+    bool IsDuplicateInBatch(const Command* batch, uint16_t count, const Command& cm) const;
+    bool SendToBack(Command& command, TickType_t waitTicks);
+    bool DropOldest();
+
+    // Statistics
+    void StampEnqueueTick(Command& command) const;
+    void RecordSendResult(bool success);
+    void RecordReceive(const Command& cm);
+
     //RTOS
     QueueHandle_t rtQueueHandle;    // RTOS Event Queue Handle
-    
+    QueueHandle_t rtPriorityQueueHandle;    // RTOS high priority lane Queue Handle, nullptr if the queue has no priority lane
+    SemaphoreHandle_t rtItemCountSemaphore;    // Counts items across both lanes so a receiver can block on either, nullptr without a priority lane
+
     //Data
     uint16_t queueDepth;            // Max queue depth
+    uint16_t priorityQueueDepth;    // Max priority lane depth, 0 if there is no priority lane
+
+    CoalescePredicate coalescePredicate;    // Idempotent command predicate, nullptr if coalescing is disabled
+    QUEUE_SEND_POLICY sendPolicy;           // Policy used by Send()
+
+    QueueStats stats;               // Send, drop, depth and latency statistics
+};
+
+/**
+ * @brief Queue with statically allocated storage for both lanes and the item count semaphore, sized at compile time
+ */
+template<uint16_t DEPTH, uint16_t PRIORITY_DEPTH = 0>
+class StaticQueue : public Queue
+{
+public:
+    StaticQueue() : Queue(DEPTH, PRIORITY_DEPTH, queueStorage_, &queueBuffer_,
+        priorityQueueStorage_, &priorityQueueBuffer_, &itemCountSemaphoreBuffer_) {}
+
+private:
+    StaticQueue(const StaticQueue&);                // Prevent copy-construction
+    StaticQueue& operator=(const StaticQueue&);    // Prevent assignment
+
+    uint8_t queueStorage_[DEPTH * sizeof(Command)];
+    uint8_t priorityQueueStorage_[(PRIORITY_DEPTH > 0 ? PRIORITY_DEPTH : 1) * sizeof(Command)];    // Unused without a priority lane
+    StaticQueue_t queueBuffer_;
+    StaticQueue_t priorityQueueBuffer_;
+    StaticSemaphore_t itemCountSemaphoreBuffer_;
 };
 
 #endif /* AVIONICS_INCLUDE_SOAR_CORE_QUEUE_H */
\ No newline at end of file
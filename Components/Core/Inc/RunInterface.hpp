@@ -15,4 +15,16 @@ void cpp_USART2_IRQHandler();
 void cpp_USART3_IRQHandler();
 void cpp_USART5_IRQHandler();
 
+void cpp_USART1_TX_DMA_IRQHandler();
+void cpp_USART2_TX_DMA_IRQHandler();
+void cpp_USART3_TX_DMA_IRQHandler();
+void cpp_USART5_TX_DMA_IRQHandler();
+
+void cpp_USART1_RX_DMA_IRQHandler();
+void cpp_USART2_RX_DMA_IRQHandler();
+void cpp_USART3_RX_DMA_IRQHandler();
+void cpp_USART5_RX_DMA_IRQHandler();
+
+void cpp_IMU_SPI_RX_DMA_IRQHandler();
+
 #endif /* C__IFACE_HPP_ */
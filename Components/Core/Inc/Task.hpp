@@ -14,21 +14,48 @@
 
 /* Enums -----------------------------------------------------------------*/
 
-/* Class -----------------------------------------------------------------*/
+/* Structs -----------------------------------------------------------------*/
+/**
+ * @brief Statically allocated stack and control block for xTaskCreateStatic, sized at compile time
+ */
+template<uint16_t STACK_DEPTH_WORDS>
+struct TaskStorage
+{
+    StackType_t stack[STACK_DEPTH_WORDS];
+    StaticTask_t controlBlock;
+};
 
+/* Class -----------------------------------------------------------------*/
+/**
+ * @brief Base class for all tasks.
+ *
+ * Tasks are singletons. Each keeps its instance in a static inst_ member defined in its .cpp, so every task is
+ * constructed during static initialization (before main and the scheduler) and Inst() returns the reference
+ * without a function-local static guard. The order in which different .cpp files are initialized is unspecified,
+ * so task constructors must not use other singletons or globals that need a constructor (e.g. Global::vaListMutex).
+ * Constant pointers like UART::Debug are fine, anything that talks to another task belongs in InitTask() or Run().
+ */
 class Task {
 public:
     //Constructors
     Task(void);
     Task(uint16_t depth);
+    Task(uint16_t depth, uint16_t priorityDepth);    // Event queue with a high priority lane
+    Task(Queue* eventQueue);    // Uses an externally owned (usually StaticQueue member) event queue, only the pointer is stored
 
     void InitTask();
 
     Queue* GetEventQueue() const { return qEvtQueue; }
     void SendCommand(Command cmd) { qEvtQueue->Send(cmd); }
     void SendCommandReference(Command& cmd) { qEvtQueue->Send(cmd); }
+    void SendPriorityCommand(Command cmd) { qEvtQueue->SendPriority(cmd); }    // Bypasses queued normal commands, use for control actions, state persistence and heartbeats
 
 protected:
+    // Opt-in batched event handling, a task calls RunBatchedEventLoop() from Run() and overrides HandleCommand() and/or HandleCommandBatch()
+    void RunBatchedEventLoop();    // Blocks for a command, then handles everything queued (up to MAX_COMMAND_BATCH_SIZE) as one batch
+    virtual void HandleCommandBatch(Command* cmds, uint16_t count);    // Handles a batch of commands, by default calls HandleCommand() on each in order
+    virtual void HandleCommand(Command& cm);    // Handles a single command, must Reset() the command
+
     //RTOS
     TaskHandle_t rtTaskHandle;        // RTOS Task Handle
 
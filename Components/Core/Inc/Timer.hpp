@@ -30,7 +30,7 @@ enum TimerState {
 /**
  * @brief Timer class
  *
- * Wrapper for FreeRTOS Timers
+ * Wrapper for FreeRTOS Timers, the RTOS timer structure is stored in the object so no heap is used
 */
 class Timer
 {
@@ -59,6 +59,7 @@ protected:
 
     TimerState timerState; // Enum that holds current timer state
     TimerHandle_t rtTimerHandle;
+    StaticTimer_t rtTimerBuffer; // Storage for the RTOS timer structure
     uint32_t timerPeriod = DEFAULT_TIMER_PERIOD;
     uint32_t remainingTimeBetweenPauses; // Calculates time left on timer when it is paused
 
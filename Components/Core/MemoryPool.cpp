@@ -0,0 +1,209 @@
+/**
+ ******************************************************************************
+ * File Name          : MemoryPool.cpp
+ * Description        : Fixed-block, size-class memory pool used for Command payloads.
+ *
+ * All pool storage is statically allocated and sized in SystemDefines.hpp. Every pool
+ * operation runs inside an interrupt-masking critical section, so the pool can be used
+ * from ISRs (eg. SendFromISR with payloads) as well as tasks.
+ ******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "MemoryPool.hpp"
+#include "SystemDefines.hpp"
+
+/* Static Storage ------------------------------------------------------------*/
+alignas(8) static uint8_t pool16Storage[16 * MEMORY_POOL_16B_NUM_BLOCKS];
+alignas(8) static uint8_t pool32Storage[32 * MEMORY_POOL_32B_NUM_BLOCKS];
+alignas(8) static uint8_t pool64Storage[64 * MEMORY_POOL_64B_NUM_BLOCKS];
+alignas(8) static uint8_t pool128Storage[128 * MEMORY_POOL_128B_NUM_BLOCKS];
+alignas(8) static uint8_t pool256Storage[256 * MEMORY_POOL_256B_NUM_BLOCKS];
+
+// Size classes, must be ordered from smallest to largest block size
+static BlockPool sizeClasses[] = {
+    BlockPool(pool16Storage, 16, MEMORY_POOL_16B_NUM_BLOCKS),
+    BlockPool(pool32Storage, 32, MEMORY_POOL_32B_NUM_BLOCKS),
+    BlockPool(pool64Storage, 64, MEMORY_POOL_64B_NUM_BLOCKS),
+    BlockPool(pool128Storage, 128, MEMORY_POOL_128B_NUM_BLOCKS),
+    BlockPool(pool256Storage, 256, MEMORY_POOL_256B_NUM_BLOCKS),
+};
+
+constexpr uint8_t NUM_SIZE_CLASSES = sizeof(sizeClasses) / sizeof(sizeClasses[0]);
+
+/* Static Variable Init ------------------------------------------------------*/
+uint16_t MemoryPool::heapFallbackInUse_ = 0;
+uint32_t MemoryPool::heapFallbackCount_ = 0;
+
+/* BlockPool -----------------------------------------------------------------*/
+/**
+ * @brief Allocates a single block from the pool, ISR safe
+ * @return Pointer to the block, or nullptr if the pool is exhausted
+ */
+uint8_t* BlockPool::Allocate()
+{
+    uint8_t* block = nullptr;
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+
+    if (freeList_ != nullptr) {
+        block = reinterpret_cast<uint8_t*>(freeList_);
+        freeList_ = freeList_->next;
+    }
+    else if (numUntouched_ > 0) {
+        block = storage_ + (uint32_t)blockSize_ * (numBlocks_ - numUntouched_);
+        numUntouched_--;
+    }
+
+    if (block != nullptr) {
+        inUse_++;
+        if (inUse_ > highWatermark_)
+            highWatermark_ = inUse_;
+    }
+    else {
+        exhaustionCount_++;
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+    return block;
+}
+
+/**
+ * @brief Returns a block to the pool, ISR safe
+ * @param block Block previously returned by Allocate() on this pool
+ */
+void BlockPool::Free(uint8_t* block)
+{
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+
+    FreeBlock* freed = reinterpret_cast<FreeBlock*>(block);
+    freed->next = freeList_;
+    freeList_ = freed;
+    inUse_--;
+
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/**
+ * @brief Copies a consistent snapshot of the pool statistics
+ * @param stats Output statistics
+ */
+void BlockPool::GetStats(MemoryPoolStats& stats) const
+{
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    stats.blockSize = blockSize_;
+    stats.numBlocks = numBlocks_;
+    stats.inUse = inUse_;
+    stats.highWatermark = highWatermark_;
+    stats.exhaustionCount = exhaustionCount_;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/* MemoryPool ----------------------------------------------------------------*/
+/**
+ * @brief Allocates memory from the smallest size class that fits, falls back to the RTOS heap
+ *        when the request is too large or all fitting classes are exhausted. The heap fallback is
+ *        not available from an ISR, in which case nullptr is returned.
+ * @param size Number of bytes required
+ * @return Pointer to the allocated memory, or nullptr when called from an ISR and no block is available
+ */
+uint8_t* MemoryPool::Allocate(uint16_t size)
+{
+    for (uint8_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+        if (size > sizeClasses[i].GetBlockSize())
+            continue;
+
+        uint8_t* block = sizeClasses[i].Allocate();
+        if (block != nullptr)
+            return block;
+    }
+
+    // The RTOS heap must not be used from an ISR
+    if (xPortIsInsideInterrupt())
+        return nullptr;
+
+    uint8_t* ret = soar_malloc(size);
+
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    heapFallbackInUse_++;
+    heapFallbackCount_++;
+    uint16_t inUse = heapFallbackInUse_;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+
+    SOAR_ASSERT(inUse < MEMORY_POOL_MAX_HEAP_FALLBACK_ALLOCATIONS, "Too many outstanding heap fallback allocations");
+    return ret;
+}
+
+/**
+ * @brief Frees memory returned by Allocate(), ISR safe for pool-owned memory
+ * @param ptr Pointer returned by Allocate()
+ */
+void MemoryPool::Free(uint8_t* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    for (uint8_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+        if (sizeClasses[i].Owns(ptr)) {
+            sizeClasses[i].Free(ptr);
+            return;
+        }
+    }
+
+    // Not pool memory, so it came from the heap fallback
+    soar_free(ptr);
+
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    heapFallbackInUse_--;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/**
+ * @brief Gets the usable size of memory returned by Allocate(), which can be larger than was requested
+ * @param ptr Pointer returned by Allocate()
+ * @return Block size of the size class that owns ptr, 0 if ptr came from the heap fallback
+ */
+uint16_t MemoryPool::GetBlockSize(const uint8_t* ptr)
+{
+    for (uint8_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+        if (sizeClasses[i].Owns(ptr))
+            return sizeClasses[i].GetBlockSize();
+    }
+    return 0;
+}
+
+/**
+ * @brief Gets the number of size classes
+ */
+uint8_t MemoryPool::GetNumClasses()
+{
+    return NUM_SIZE_CLASSES;
+}
+
+/**
+ * @brief Gets the statistics of a single size class
+ * @param classIdx Index of the size class, smallest class is 0
+ * @param stats Output statistics
+ * @return false if classIdx is out of range
+ */
+bool MemoryPool::GetClassStats(uint8_t classIdx, MemoryPoolStats& stats)
+{
+    if (classIdx >= NUM_SIZE_CLASSES)
+        return false;
+
+    sizeClasses[classIdx].GetStats(stats);
+    return true;
+}
+
+/**
+ * @brief Prints the statistics for every size class and the heap fallback
+ */
+void MemoryPool::PrintStats()
+{
+    SOAR_PRINT("\n\t-- Memory Pool Stats --\n");
+    for (uint8_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+        MemoryPoolStats stats;
+        sizeClasses[i].GetStats(stats);
+        SOAR_PRINT("%3dB : %3d/%3d used, high %3d, exhausted %d\n",
+            stats.blockSize, stats.inUse, stats.numBlocks, stats.highWatermark, stats.exhaustionCount);
+    }
+    SOAR_PRINT("Heap : %d used, %d total fallbacks\n\n", heapFallbackInUse_, heapFallbackCount_);
+}
@@ -15,7 +15,7 @@
  */
 Mutex::Mutex()
 {
-    rtSemaphoreHandle = xSemaphoreCreateMutex();
+    rtSemaphoreHandle = xSemaphoreCreateMutexStatic(&rtSemaphoreBuffer);
 
     SOAR_ASSERT(rtSemaphoreHandle != NULL, "Semaphore creation failed.");
 }
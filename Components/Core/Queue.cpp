@@ -9,26 +9,93 @@
 #include "SystemDefines.hpp"
 #include "FreeRTOS.h"
 
+#include <cstring>     // Support for memset
 
 /**
  * @brief Constructor for the Queue class uses DEFAULT_QUEUE_SIZE for queue depth
 */
-Queue::Queue(void)
+Queue::Queue(void) : Queue(DEFAULT_QUEUE_SIZE, 0)
 {
-    //Initialize RTOS Queue handle
-    rtQueueHandle = xQueueCreate(DEFAULT_QUEUE_SIZE, sizeof(Command));
-    queueDepth = 0;
 }
 
 /**
  * @brief Constructor with depth for the Queue class
  * @param depth Queue depth
 */
-Queue::Queue(uint16_t depth)
+Queue::Queue(uint16_t depth) : Queue(depth, 0)
 {
+}
+
+/**
+ * @brief Constructor with depth and priority lane depth for the Queue class
+ * @param depth Queue depth of the normal lane
+ * @param priorityDepth Queue depth of the high priority lane, 0 for a single lane queue
+*/
+Queue::Queue(uint16_t depth, uint16_t priorityDepth) : Queue(depth, priorityDepth, nullptr, nullptr, nullptr, nullptr, nullptr)
+{
+}
+
+/**
+ * @brief Constructor with externally provided storage, used by StaticQueue
+ * @param depth Queue depth of the normal lane
+ * @param priorityDepth Queue depth of the high priority lane, 0 for a single lane queue
+ * @param queueStorage Storage for depth Commands, nullptr to allocate everything from the heap
+ * @param queueBuffer RTOS queue structure for the normal lane
+ * @param priorityQueueStorage Storage for priorityDepth Commands, unused if priorityDepth is 0
+ * @param priorityQueueBuffer RTOS queue structure for the priority lane, unused if priorityDepth is 0
+ * @param itemCountSemaphoreBuffer RTOS semaphore structure for the item count, unused if priorityDepth is 0
+*/
+Queue::Queue(uint16_t depth, uint16_t priorityDepth, uint8_t* queueStorage, StaticQueue_t* queueBuffer,
+    uint8_t* priorityQueueStorage, StaticQueue_t* priorityQueueBuffer, StaticSemaphore_t* itemCountSemaphoreBuffer)
+{
+    bool isStatic = (queueStorage != nullptr);
+
     //Initialize RTOS Queue handle with given depth
-    rtQueueHandle = xQueueCreate(depth, sizeof(Command));
+    if (isStatic)
+        rtQueueHandle = xQueueCreateStatic(depth, sizeof(Command), queueStorage, queueBuffer);
+    else
+        rtQueueHandle = xQueueCreate(depth, sizeof(Command));
     queueDepth = depth;
+
+    //Initialize the priority lane, the semaphore counts the items in both lanes
+    rtPriorityQueueHandle = nullptr;
+    rtItemCountSemaphore = nullptr;
+    priorityQueueDepth = priorityDepth;
+    if (priorityDepth > 0) {
+        if (isStatic) {
+            rtPriorityQueueHandle = xQueueCreateStatic(priorityDepth, sizeof(Command), priorityQueueStorage, priorityQueueBuffer);
+            rtItemCountSemaphore = xSemaphoreCreateCountingStatic(depth + priorityDepth, 0, itemCountSemaphoreBuffer);
+        }
+        else {
+            rtPriorityQueueHandle = xQueueCreate(priorityDepth, sizeof(Command));
+            rtItemCountSemaphore = xSemaphoreCreateCounting(depth + priorityDepth, 0);
+        }
+    }
+
+    coalescePredicate = nullptr;
+    sendPolicy = QUEUE_SEND_BLOCK;
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * @brief Enables coalescing on batch receives. A command that the predicate marks idempotent and that is identical
+ *        (GLOBAL_COMMAND and task command) to one already in the batch is reset and dropped, the queue keeps draining
+ *        in its place so a backlog of N identical requests is handled once.
+ * @param isIdempotent Predicate deciding which commands may be merged, must only accept commands without data
+*/
+void Queue::EnableCoalescing(CoalescePredicate isIdempotent)
+{
+    coalescePredicate = isIdempotent;
+}
+
+/**
+ * @brief Default coalescing predicate, REQUEST_COMMANDs carry no data and only ask for the latest state, so duplicates are redundant
+ * @param cm Command to check
+ * @return true if cm is a REQUEST_COMMAND without data
+*/
+bool Queue::IsDataFreeRequest(const Command& cm)
+{
+    return cm.GetCommand() == REQUEST_COMMAND && cm.GetDataSize() == 0;
 }
 
 /**
@@ -39,9 +106,15 @@ Queue::Queue(uint16_t depth)
 bool Queue::SendFromISR(Command& command)
 {
     //Note: There NULL param here could be used to wake a task right after after exiting the ISR
-    if (xQueueSendFromISR(rtQueueHandle, &command, NULL) == pdPASS)
+    StampEnqueueTick(command);
+    if (xQueueSendFromISR(rtQueueHandle, &command, NULL) == pdPASS) {
+        if (rtItemCountSemaphore != nullptr)
+            xSemaphoreGiveFromISR(rtItemCountSemaphore, NULL);
+        RecordSendResult(true);
         return true;
+    }
 
+    RecordSendResult(false);
     command.Reset();
 
     return false;
@@ -54,10 +127,16 @@ bool Queue::SendFromISR(Command& command)
  */
 bool Queue::SendToFront(Command& command)
 {
-    //Send to the back of the queue
-    if (xQueueSendToFront(rtQueueHandle, &command, DEFAULT_QUEUE_SEND_WAIT_TICKS) == pdPASS)
+    //Send to the front of the queue
+    StampEnqueueTick(command);
+    if (xQueueSendToFront(rtQueueHandle, &command, DEFAULT_QUEUE_SEND_WAIT_TICKS) == pdPASS) {
+        if (rtItemCountSemaphore != nullptr)
+            xSemaphoreGive(rtItemCountSemaphore);
+        RecordSendResult(true);
         return true;
+    }
 
+    RecordSendResult(false);
     SOAR_PRINT("Could not send data to front of queue!\n");
     command.Reset();
 
@@ -65,21 +144,150 @@ bool Queue::SendToFront(Command& command)
 }
 
 /**
- * @brief Sends a command object to the queue (sends to back of queue in FIFO order)
+ * @brief Sends a command object to the high priority lane, which is always received before the normal lane
+ *        so the command never waits behind queued low priority traffic. Commands in the priority lane are FIFO.
+ * @param command Command object reference to send
+ * @return true on success, false on failure (queue full)
+ */
+bool Queue::SendPriority(Command& command)
+{
+    if (rtPriorityQueueHandle == nullptr)
+        return SendToFront(command);
+
+    StampEnqueueTick(command);
+    if (xQueueSend(rtPriorityQueueHandle, &command, DEFAULT_QUEUE_SEND_WAIT_TICKS) == pdPASS) {
+        xSemaphoreGive(rtItemCountSemaphore);
+        RecordSendResult(true);
+        return true;
+    }
+
+    RecordSendResult(false);
+    SOAR_PRINT("Could not send data to priority queue!\n");
+    command.Reset();
+
+    return false;
+}
+
+/**
+ * @brief Sends a command object to the high priority lane, safe to call from ISR
  * @param command Command object reference to send
+ * @return true on success, false on failure (queue full), without a priority lane this sends to the front of the queue
+ */
+bool Queue::SendPriorityFromISR(Command& command)
+{
+    StampEnqueueTick(command);
+    if (rtPriorityQueueHandle == nullptr) {
+        if (xQueueSendToFrontFromISR(rtQueueHandle, &command, NULL) == pdPASS) {
+            RecordSendResult(true);
+            return true;
+        }
+    }
+    else if (xQueueSendFromISR(rtPriorityQueueHandle, &command, NULL) == pdPASS) {
+        xSemaphoreGiveFromISR(rtItemCountSemaphore, NULL);
+        RecordSendResult(true);
+        return true;
+    }
+
+    RecordSendResult(false);
+    command.Reset();
+
+    return false;
+}
+
+/**
+ * @brief Sends a command object to the queue (sends to back of queue in FIFO order) using the queue send policy
+ * @param command Command object reference to send, reset on failure whatever the policy
  * @return true on success, false on failure (queue full)
 */
 bool Queue::Send(Command& command)
 {
-    if (xQueueSend(rtQueueHandle, &command, DEFAULT_QUEUE_SEND_WAIT_TICKS) == pdPASS)
-        return true;
+    QUEUE_SEND_RESULT result = SendWithPolicy(command, sendPolicy);
+
+    // Callers of Send() do not handle QUEUE_SEND_FULL, so a QUEUE_SEND_FAIL default must not leave them the data
+    if (result == QUEUE_SEND_FULL)
+        command.Reset();
+
+    return (result == QUEUE_SEND_OK) || (result == QUEUE_SEND_OK_DROPPED_OLDEST);
+}
+
+/**
+ * @brief Sends a command object to the back of the queue, only QUEUE_SEND_BLOCK waits for space, so producers
+ *        that must stay on schedule can shed load instead of stalling
+ * @param command Command object reference to send, reset unless it was queued or the result is QUEUE_SEND_FULL
+ * @param policy What to do when the queue is full
+ * @return Result of the send, anything but QUEUE_SEND_OK means the consumer is falling behind
+*/
+QUEUE_SEND_RESULT Queue::SendWithPolicy(Command& command, QUEUE_SEND_POLICY policy)
+{
+    TickType_t waitTicks = (policy == QUEUE_SEND_BLOCK) ? DEFAULT_QUEUE_SEND_WAIT_TICKS : 0;
+
+    StampEnqueueTick(command);
+    if (SendToBack(command, waitTicks)) {
+        RecordSendResult(true);
+        return QUEUE_SEND_OK;
+    }
+
+    // Another producer may refill the space we made, in which case the new command is dropped as well
+    if (policy == QUEUE_SEND_DROP_OLDEST && DropOldest() && SendToBack(command, 0)) {
+        RecordSendResult(true);
+        return QUEUE_SEND_OK_DROPPED_OLDEST;
+    }
+
+    RecordSendResult(false);
+
+    if (policy == QUEUE_SEND_FAIL)
+        return QUEUE_SEND_FULL;
 
     //TODO: It may be possible to have this automatically set the command to not free data externally as we've "passed" control of the data over, which might let us use a destructor to free the data
 
-    SOAR_PRINT("Could not send data to queue!\n");
+    // Non-blocking policies expect to drop under load, that is tracked in the stats rather than printed
+    if (policy == QUEUE_SEND_BLOCK)
+        SOAR_PRINT("Could not send data to queue!\n");
     command.Reset();
 
-    return false;
+    return QUEUE_SEND_DROPPED;
+}
+
+/**
+ * @brief Sends a command object to the back of the normal lane and counts it on the item semaphore
+ * @param command Command object reference to send
+ * @param waitTicks Time to wait for space in RTOS ticks
+ * @return true if the command was queued
+*/
+bool Queue::SendToBack(Command& command, TickType_t waitTicks)
+{
+    if (xQueueSend(rtQueueHandle, &command, waitTicks) != pdPASS)
+        return false;
+
+    if (rtItemCountSemaphore != nullptr)
+        xSemaphoreGive(rtItemCountSemaphore);
+    return true;
+}
+
+/**
+ * @brief Discards the oldest command in the normal lane, the priority lane is never dropped from
+ * @return true if a command was discarded
+*/
+bool Queue::DropOldest()
+{
+    // Take the item count first so a receiver never waits on an item we are about to remove
+    if (rtItemCountSemaphore != nullptr && xSemaphoreTake(rtItemCountSemaphore, 0) != pdTRUE)
+        return false;
+
+    Command oldest;
+    if (xQueueReceive(rtQueueHandle, &oldest, 0) != pdTRUE) {
+        // The counted item was in the priority lane (or already received), give the count back
+        if (rtItemCountSemaphore != nullptr)
+            xSemaphoreGive(rtItemCountSemaphore);
+        return false;
+    }
+
+    oldest.Reset();
+
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    stats.droppedOldestCount++;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+    return true;
 }
 
 /**
@@ -90,10 +298,7 @@ bool Queue::Send(Command& command)
 */
 bool Queue::Receive(Command& cm, uint32_t timeout_ms)
 {
-    if(xQueueReceive(rtQueueHandle, &cm, MS_TO_TICKS(timeout_ms)) == pdTRUE) {
-        return true;
-    }
-    return false;
+    return ReceiveTicks(cm, MS_TO_TICKS(timeout_ms));
 }
 
 /**
@@ -103,8 +308,190 @@ bool Queue::Receive(Command& cm, uint32_t timeout_ms)
 */
 bool Queue::ReceiveWait(Command& cm)
 {
-    if (xQueueReceive(rtQueueHandle, &cm, HAL_MAX_DELAY) == pdTRUE) {
-        return true;
+    return ReceiveTicks(cm, HAL_MAX_DELAY);
+}
+
+/**
+ * @brief Receive implementation, blocks for up to timeoutTicks, always takes from the priority lane first
+ * @param cm Command object to copy received data into
+ * @param timeoutTicks Time to block for in RTOS ticks
+ * @return TRUE if we received a command, FALSE otherwise
+*/
+bool Queue::ReceiveTicks(Command& cm, TickType_t timeoutTicks)
+{
+    bool received = false;
+
+    if (rtItemCountSemaphore == nullptr) {
+        received = (xQueueReceive(rtQueueHandle, &cm, timeoutTicks) == pdTRUE);
+    }
+    // Every item in either lane is counted by the semaphore, so after taking it one of the lanes has an item for us
+    else if (xSemaphoreTake(rtItemCountSemaphore, timeoutTicks) == pdTRUE) {
+        received = (xQueueReceive(rtPriorityQueueHandle, &cm, 0) == pdTRUE)
+            || (xQueueReceive(rtQueueHandle, &cm, 0) == pdTRUE);
+    }
+
+    if (received)
+        RecordReceive(cm);
+
+    return received;
+}
+
+/**
+ * @brief Blocks for up to timeout_ms for the first command, then drains any further queued commands
+ *        without blocking, so a burst is handled with one wake-up
+ * @param out Array of at least maxCount commands to copy received data into
+ * @param maxCount Maximum number of commands to receive
+ * @param timeout_ms Time to block for the first command
+ * @return Number of commands received into out
+*/
+uint16_t Queue::ReceiveBatch(Command* out, uint16_t maxCount, uint32_t timeout_ms)
+{
+    return ReceiveBatchTicks(out, maxCount, MS_TO_TICKS(timeout_ms));
+}
+
+/**
+ * @brief Blocks forever for the first command, then drains any further queued commands without blocking
+ * @param out Array of at least maxCount commands to copy received data into
+ * @param maxCount Maximum number of commands to receive
+ * @return Number of commands received into out (should rarely be 0)
+*/
+uint16_t Queue::ReceiveBatchWait(Command* out, uint16_t maxCount)
+{
+    return ReceiveBatchTicks(out, maxCount, HAL_MAX_DELAY);
+}
+
+/**
+ * @brief Batch receive implementation, blocks for the first command for up to timeoutTicks
+ * @param out Array of at least maxCount commands to copy received data into
+ * @param maxCount Maximum number of commands to receive
+ * @param timeoutTicks Time to block for the first command in RTOS ticks
+ * @return Number of commands received into out
+*/
+uint16_t Queue::ReceiveBatchTicks(Command* out, uint16_t maxCount, TickType_t timeoutTicks)
+{
+    if (maxCount == 0 || !ReceiveTicks(out[0], timeoutTicks))
+        return 0;
+
+    uint16_t count = 1;
+    while (count < maxCount && ReceiveTicks(out[count], 0)) {
+        // Merge duplicates of idempotent commands into the first occurrence, the slot is reused for the next command
+        if (coalescePredicate != nullptr && IsDuplicateInBatch(out, count, out[count])) {
+            out[count].Reset();
+            UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+            stats.coalescedCount++;
+            taskEXIT_CRITICAL_FROM_ISR(mask);
+            continue;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Checks whether an idempotent command is already present in the batch
+ * @param batch Commands already accepted into the batch
+ * @param count Number of commands in batch
+ * @param cm Command to check
+ * @return true if cm is idempotent and an identical command is in the batch
+*/
+bool Queue::IsDuplicateInBatch(const Command* batch, uint16_t count, const Command& cm) const
+{
+    if (!coalescePredicate(cm))
+        return false;
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (batch[i].GetCommand() == cm.GetCommand() && batch[i].GetTaskCommand() == cm.GetTaskCommand()
+            && coalescePredicate(batch[i]))
+            return true;
     }
     return false;
 }
+
+/**
+ * @brief Gets the number of commands waiting in the queue, including the priority lane
+ * @return Number of commands waiting
+*/
+uint16_t Queue::GetQueueMessageCount() const
+{
+    uint16_t count = uxQueueMessagesWaiting(rtQueueHandle);
+    if (rtPriorityQueueHandle != nullptr)
+        count += uxQueueMessagesWaiting(rtPriorityQueueHandle);
+    return count;
+}
+
+/**
+ * @brief Copies a consistent snapshot of the queue statistics
+ * @param out Output statistics
+*/
+void Queue::GetStats(QueueStats& out) const
+{
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    out = stats;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/**
+ * @brief Clears all queue statistics
+*/
+void Queue::ResetStats()
+{
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    memset(&stats, 0, sizeof(stats));
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/**
+ * @brief Stamps the command with the current tick count before it is copied into the RTOS queue, ISR safe
+ * @param command Command about to be sent
+*/
+void Queue::StampEnqueueTick(Command& command) const
+{
+    command.enqueueTick = (uint16_t)(xPortIsInsideInterrupt() ? xTaskGetTickCountFromISR() : xTaskGetTickCount());
+}
+
+/**
+ * @brief Records the result of a send and updates the depth high-watermark, ISR safe
+ * @param success Whether the command was accepted by the queue
+*/
+void Queue::RecordSendResult(bool success)
+{
+    // FromISR variants as this can run in an ISR, they are equally valid from a task
+    uint16_t depth = 0;
+    if (success) {
+        depth = uxQueueMessagesWaitingFromISR(rtQueueHandle);
+        if (rtPriorityQueueHandle != nullptr)
+            depth += uxQueueMessagesWaitingFromISR(rtPriorityQueueHandle);
+    }
+
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    if (success) {
+        stats.sendCount++;
+        if (depth > stats.depthHighWatermark)
+            stats.depthHighWatermark = depth;
+    }
+    else {
+        stats.failedSendCount++;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/**
+ * @brief Adds the enqueue to dequeue latency of a received command to the log2 histogram
+ * @param cm Received command
+*/
+void Queue::RecordReceive(const Command& cm)
+{
+    uint16_t latency = (uint16_t)xTaskGetTickCount() - cm.enqueueTick;
+
+    // Bin is the bit width of the latency, clamped to the last bin
+    uint8_t bin = 0;
+    while (latency != 0 && bin < QUEUE_LATENCY_HISTOGRAM_BINS - 1) {
+        latency >>= 1;
+        bin++;
+    }
+
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    stats.latencyHistogram[bin]++;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
@@ -7,6 +7,7 @@
 
 #include "main_avionics.hpp"
 #include "UARTDriver.hpp"
+#include "IMUTask.hpp"
 
 extern "C" {
     void run_interface()
@@ -33,6 +34,51 @@ extern "C" {
     {
         Driver::uart5.HandleIRQ_UART();
     }
+
+    void cpp_USART1_TX_DMA_IRQHandler()
+    {
+        Driver::uart1.HandleIRQ_TxDMA();
+    }
+
+    void cpp_USART2_TX_DMA_IRQHandler()
+    {
+        Driver::uart2.HandleIRQ_TxDMA();
+    }
+
+    void cpp_USART3_TX_DMA_IRQHandler()
+    {
+        Driver::uart3.HandleIRQ_TxDMA();
+    }
+
+    void cpp_USART5_TX_DMA_IRQHandler()
+    {
+        Driver::uart5.HandleIRQ_TxDMA();
+    }
+
+    void cpp_USART1_RX_DMA_IRQHandler()
+    {
+        Driver::uart1.HandleIRQ_RxDMA();
+    }
+
+    void cpp_USART2_RX_DMA_IRQHandler()
+    {
+        Driver::uart2.HandleIRQ_RxDMA();
+    }
+
+    void cpp_USART3_RX_DMA_IRQHandler()
+    {
+        Driver::uart3.HandleIRQ_RxDMA();
+    }
+
+    void cpp_USART5_RX_DMA_IRQHandler()
+    {
+        Driver::uart5.HandleIRQ_RxDMA();
+    }
+
+    void cpp_IMU_SPI_RX_DMA_IRQHandler()
+    {
+        IMUTask::Inst().HandleIRQ_SpiRxDMA();
+    }
 }
 
 
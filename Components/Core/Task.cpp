@@ -5,6 +5,7 @@
  ******************************************************************************
 */
 #include "Task.hpp"
+#include "SystemDefines.hpp"
 
 /**
  * @brief Default constructor, instantiates event queue with default size
@@ -27,3 +28,63 @@ Task::Task(uint16_t depth)
         qEvtQueue = new Queue(depth);
     rtTaskHandle = nullptr;
 }
+
+/**
+ * @brief Constructor with queue depth and priority lane depth
+ * @param depth Depth of the normal lane of the event queue
+ * @param priorityDepth Depth of the high priority lane of the event queue
+*/
+Task::Task(uint16_t depth, uint16_t priorityDepth)
+{
+    qEvtQueue = new Queue(depth, priorityDepth);
+    rtTaskHandle = nullptr;
+}
+
+/**
+ * @brief Constructor with an externally owned event queue, lets a task keep its queue in static storage
+ * @param eventQueue Event queue of the task, may not be constructed yet as only the pointer is stored
+*/
+Task::Task(Queue* eventQueue)
+{
+    qEvtQueue = eventQueue;
+    rtTaskHandle = nullptr;
+}
+
+/**
+ * @brief Batched run loop, blocks until a command arrives then receives every queued command (up to MAX_COMMAND_BATCH_SIZE)
+ *        and hands them to HandleCommandBatch() together, costing one wake-up per burst instead of one per command
+*/
+void Task::RunBatchedEventLoop()
+{
+    Command batch[MAX_COMMAND_BATCH_SIZE];
+
+    while (1) {
+        //Wait forever for at least one command
+        uint16_t count = qEvtQueue->ReceiveBatchWait(batch, MAX_COMMAND_BATCH_SIZE);
+
+        //Process the batch
+        if (count > 0)
+            HandleCommandBatch(batch, count);
+    }
+}
+
+/**
+ * @brief Handles a batch of commands received by RunBatchedEventLoop(), default handles each command in order
+ * @param cmds Array of received commands, each must be Reset() by the handler
+ * @param count Number of commands in cmds
+*/
+void Task::HandleCommandBatch(Command* cmds, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+        HandleCommand(cmds[i]);
+}
+
+/**
+ * @brief Default single command handler for tasks that use RunBatchedEventLoop() without overriding it
+ * @param cm Command to handle, reset after handling
+*/
+void Task::HandleCommand(Command& cm)
+{
+    SOAR_PRINT("Task - Received Unsupported Command {%d}\n", cm.GetCommand());
+    cm.Reset();
+}
@@ -18,7 +18,7 @@ Timer::Timer()
     // We make a timer named "Timer" with a callback function that does nothing, Autoreload false, and the default period of 1s.
     // The timer ID is specified as (void *)this to provide a unique ID for each timer object - however this is not necessary for polling timers.
     // The timer is created in the dormant state.
-    rtTimerHandle = xTimerCreate("Timer", timerPeriod, pdFALSE, (void *)this, DefaultCallback);
+    rtTimerHandle = xTimerCreateStatic("Timer", timerPeriod, pdFALSE, (void *)this, DefaultCallback, &rtTimerBuffer);
     SOAR_ASSERT(rtTimerHandle, "Error Occurred, Timer not created");
     timerState = UNINITIALIZED;
 }
@@ -32,7 +32,7 @@ Timer::Timer()
 */
 Timer::Timer(void (*TimerDefaultCallback_t)( TimerHandle_t xTimer ))
 {
-    rtTimerHandle = xTimerCreate("Timer", timerPeriod, pdFALSE, (void *)this, TimerDefaultCallback_t);
+    rtTimerHandle = xTimerCreateStatic("Timer", timerPeriod, pdFALSE, (void *)this, TimerDefaultCallback_t, &rtTimerBuffer);
     SOAR_ASSERT(rtTimerHandle, "Error Occurred, Timer not created");
     timerState = UNINITIALIZED;
 }
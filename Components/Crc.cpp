@@ -0,0 +1,209 @@
+/**
+ ******************************************************************************
+ * File Name          : Crc.cpp
+ * Description        : CRC16 and CRC32 engines with incremental APIs for frames
+ *                received or built in multiple chunks.
+ *                Builds without USE_HAL_DRIVER (eg. on a host) compute the CRC32 in software,
+ *                with the same result as the peripheral.
+ ******************************************************************************
+*/
+#include "Crc.hpp"
+
+#include <cstring>
+
+#if defined(USE_HAL_DRIVER)
+#include "main_avionics.hpp"
+#include "SystemDefines.hpp"
+#endif
+
+/* Constants -----------------------------------------------------------------*/
+constexpr uint16_t CRC16_POLY = 0x1021;
+constexpr uint32_t CRC32_POLY = 0x04C11DB7;
+constexpr uint32_t CRC32_HW_MAX_WORDS_PER_LOCK = 64;    // Words fed to the peripheral per critical section, bounds interrupt latency on long buffers
+
+/* Tables --------------------------------------------------------------------*/
+// Slicing-by-4 tables, t[k][b] is the CRC of byte b followed by k zero bytes, generated at compile time into flash
+struct Crc16Tables { uint16_t t[4][256]; };
+
+static constexpr Crc16Tables MakeCrc16Tables()
+{
+    Crc16Tables tables = {};
+    for (uint16_t b = 0; b < 256; b++) {
+        uint16_t crc = (uint16_t)(b << 8);
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ CRC16_POLY) : (uint16_t)(crc << 1);
+        tables.t[0][b] = crc;
+    }
+    for (uint8_t k = 1; k < 4; k++) {
+        for (uint16_t b = 0; b < 256; b++) {
+            uint16_t prev = tables.t[k - 1][b];
+            tables.t[k][b] = (uint16_t)(prev << 8) ^ tables.t[0][prev >> 8];
+        }
+    }
+    return tables;
+}
+
+static constexpr Crc16Tables CRC16_TABLES = MakeCrc16Tables();
+
+/* Helpers -------------------------------------------------------------------*/
+/**
+ * @brief Loads a little-endian word from a possibly unaligned address, compiles to a single load on the Cortex-M4
+ */
+static inline uint32_t LoadWord(const uint8_t* data)
+{
+    uint32_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+/* Crc16 ---------------------------------------------------------------------*/
+/**
+ * @brief Adds data to the running CRC, 4 bytes per step using the slicing tables
+ * @param data The data to add
+ * @param len The size of the data in bytes
+ */
+void Crc16::Add(const uint8_t* data, uint32_t len)
+{
+    const uint16_t (&t)[4][256] = CRC16_TABLES.t;
+    uint16_t crc = crc_;
+
+    while (len >= 4) {
+        crc = t[3][(crc >> 8) ^ data[0]] ^ t[2][(crc & 0xFF) ^ data[1]] ^ t[1][data[2]] ^ t[0][data[3]];
+        data += 4;
+        len -= 4;
+    }
+
+    while (len-- > 0)
+        crc = (uint16_t)(crc << 8) ^ t[0][(crc >> 8) ^ *data++];
+
+    crc_ = crc;
+}
+
+/**
+ * @brief Calculates the CRC16 of a buffer
+ */
+uint16_t Crc16::Calculate(const uint8_t* data, uint32_t len)
+{
+    Crc16 crc;
+    crc.Add(data, len);
+    return crc.Value();
+}
+
+/* Crc32 ---------------------------------------------------------------------*/
+/**
+ * @brief Adds data to the running CRC, whole words are read straight from data without copying
+ * @param data The data to add, does not need to be aligned
+ * @param len The size of the data in bytes
+ */
+void Crc32::Add(const uint8_t* data, uint32_t len)
+{
+    // Complete the word held from the previous chunk first
+    if (tailLen_ > 0) {
+        while (tailLen_ < 4 && len > 0) {
+            tail_[tailLen_++] = *data++;
+            len--;
+        }
+        if (tailLen_ < 4)
+            return;
+
+        crc_ = AddWords(crc_, tail_, 1);
+        tailLen_ = 0;
+    }
+
+    uint32_t numWords = len / 4;
+    if (numWords > 0)
+        crc_ = AddWords(crc_, data, numWords);
+
+    tailLen_ = (uint8_t)(len % 4);
+    memcpy(tail_, data + numWords * 4, tailLen_);
+}
+
+/**
+ * @brief Gets the CRC of all the data added so far, the pending tail is zero padded but kept
+ *        so more data can still be added
+ */
+uint32_t Crc32::Value() const
+{
+    if (tailLen_ == 0)
+        return crc_;
+
+    uint8_t padded[4] = {};
+    memcpy(padded, tail_, tailLen_);
+    return AddWords(crc_, padded, 1);
+}
+
+/**
+ * @brief Calculates the CRC32 of a buffer, zero padded to a multiple of 4 bytes
+ */
+uint32_t Crc32::Calculate(const uint8_t* data, uint32_t len)
+{
+    Crc32 crc;
+    crc.Add(data, len);
+    return crc.Value();
+}
+
+#if defined(USE_HAL_DRIVER)
+/**
+ * @brief Continues a CRC over whole words using the CRC peripheral, ISR safe
+ *
+ * The peripheral can only be reset to 0xFFFFFFFF, the running value is restored by folding it into the
+ * first word: the peripheral computes f(DR ^ word), so writing word ^ crc ^ 0xFFFFFFFF after a reset
+ * gives f(crc ^ word), the same as if crc had been left in the data register.
+ * @param crc Running CRC to continue from
+ * @param data Start of the words, does not need to be aligned
+ * @param numWords Number of words, must be at least 1
+ * @return The updated CRC
+ */
+uint32_t Crc32::AddWords(uint32_t crc, const uint8_t* data, uint32_t numWords)
+{
+    CRC_TypeDef* hw = SystemHandles::CRC_Handle->Instance;
+
+    while (numWords > 0) {
+        uint32_t count = (numWords < CRC32_HW_MAX_WORDS_PER_LOCK) ? numWords : CRC32_HW_MAX_WORDS_PER_LOCK;
+
+        UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+        hw->CR = CRC_CR_RESET;
+        hw->DR = LoadWord(data) ^ crc ^ 0xFFFFFFFF;
+        for (uint32_t i = 1; i < count; i++)
+            hw->DR = LoadWord(data + i * 4);
+        crc = hw->DR;
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+
+        data += count * 4;
+        numWords -= count;
+    }
+
+    return crc;
+}
+#else
+/**
+ * @brief Continues a CRC over whole words in software, gives the same result as the CRC peripheral
+ *        which shifts each little-endian word in most significant byte first
+ * @param crc Running CRC to continue from
+ * @param data Start of the words, does not need to be aligned
+ * @param numWords Number of words
+ * @return The updated CRC
+ */
+uint32_t Crc32::AddWords(uint32_t crc, const uint8_t* data, uint32_t numWords)
+{
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t c = b << 24;
+            for (uint8_t bit = 0; bit < 8; bit++)
+                c = (c & 0x80000000) ? (c << 1) ^ CRC32_POLY : (c << 1);
+            table[b] = c;
+        }
+        tableReady = true;
+    }
+
+    for (uint32_t i = 0; i < numWords; i++) {
+        crc ^= LoadWord(data + i * 4);
+        for (uint8_t b = 0; b < 4; b++)
+            crc = (crc << 8) ^ table[crc >> 24];
+    }
+
+    return crc;
+}
+#endif
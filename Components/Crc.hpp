@@ -0,0 +1,61 @@
+/**
+ ******************************************************************************
+ * File Name          : Crc.hpp
+ * Description        : CRC16 and CRC32 engines with incremental APIs for frames
+ *                received or built in multiple chunks.
+ *                CRC16 is table driven (slicing-by-4), CRC32 streams words into the
+ *                STM32 CRC peripheral, with a software path for builds without the HAL.
+ ******************************************************************************
+*/
+#ifndef AVIONICS_INCLUDE_SOAR_CRC_HPP_
+#define AVIONICS_INCLUDE_SOAR_CRC_HPP_
+#include <cstdint>
+
+/* Class -----------------------------------------------------------------*/
+/**
+ * @brief CRC-16/XMODEM (poly 0x1021, init 0x0000, not reflected, no final xor), same result as etl::crc16_xmodem
+ */
+class Crc16
+{
+public:
+    Crc16() : crc_(0) {}
+
+    void Reset() { crc_ = 0; }
+    void Add(const uint8_t* data, uint32_t len);
+    uint16_t Value() const { return crc_; }
+
+    static uint16_t Calculate(const uint8_t* data, uint32_t len);
+
+private:
+    uint16_t crc_;
+};
+
+/**
+ * @brief CRC-32/MPEG-2 (poly 0x04C11DB7, init 0xFFFFFFFF, not reflected, no final xor) over little-endian
+ *        32 bit words, as computed by the STM32 CRC peripheral. Data that is not a multiple of 4 bytes is
+ *        zero padded to the next word.
+ *
+ * Chunks passed to Add() may have any length, bytes that do not fill a word are held until the next Add()
+ * so the result only depends on the concatenated data. The peripheral is only held for the duration of a
+ * single Add(), so any number of Crc32 objects can be in use at once.
+ */
+class Crc32
+{
+public:
+    Crc32() : crc_(0xFFFFFFFF), tailLen_(0) {}
+
+    void Reset() { crc_ = 0xFFFFFFFF; tailLen_ = 0; }
+    void Add(const uint8_t* data, uint32_t len);
+    uint32_t Value() const;    // CRC of everything added so far, with the pending tail zero padded
+
+    static uint32_t Calculate(const uint8_t* data, uint32_t len);
+
+private:
+    static uint32_t AddWords(uint32_t crc, const uint8_t* data, uint32_t numWords);
+
+    uint32_t crc_;        // CRC over all whole words added so far
+    uint8_t tail_[4];     // Bytes added that do not fill a word yet
+    uint8_t tailLen_;
+};
+
+#endif    // AVIONICS_INCLUDE_SOAR_CRC_HPP_
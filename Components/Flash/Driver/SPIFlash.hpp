@@ -27,8 +27,7 @@ public:
      * @brief Singleton instance
      */
     static SPIFlash& Inst() {
-        static SPIFlash inst;
-        return inst;
+        return inst_;
     }
 
     /**
@@ -148,6 +147,11 @@ private:
     SPIFlash& operator=(const SPIFlash&);           // Prevent assignment
 
     bool isInitialized_ = false;
+
+    static SPIFlash inst_;    // Singleton instance
 };
 
+// Header-only driver, an inline variable gives the singleton one definition without a guard
+inline SPIFlash SPIFlash::inst_;
+
 #endif // SPIFLASH_WRAPPER_HPP_
@@ -14,11 +14,15 @@
 #include "SPIFlash.hpp"
 #include "Data.h"
 #include <cstring>
+#include <new>         // Support for placement new
+
+/* Static Variable Init ------------------------------------------------------------------*/
+FlashTask FlashTask::inst_;
 
 /**
  * @brief Constructor for FlashTask
  */
-FlashTask::FlashTask() : Task(FLASH_TASK_QUEUE_DEPTH_OBJS)
+FlashTask::FlashTask() : Task(&evtQueue_)
 {
 }
 
@@ -30,15 +34,16 @@ void FlashTask::InitTask()
     // Make sure the task is not already initialized
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize flash task twice");
     
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)FlashTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)FlashTask::RunTask,
             (const char*)"FlashTask",
-            (uint16_t)FLASH_TASK_STACK_DEPTH_WORDS,
+            (uint32_t)FLASH_TASK_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)FLASH_TASK_RTOS_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
-    SOAR_ASSERT(rtValue == pdPASS, "FlashTask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "FlashTask::InitTask() - xTaskCreateStatic() failed");
 
     SOAR_PRINT("Flash Task initialized");
 }
@@ -54,7 +59,7 @@ void FlashTask::Run(void * pvParams)
         osDelay(1);
 
     // Initialize the offsets storage
-    offsetsStorage_ = new SimpleDualSectorStorage<Offsets>(&SPIFlash::Inst(), SPI_FLASH_OFFSETS_SDSS_START_ADDR);
+    offsetsStorage_ = new (offsetsStorageMem_) SimpleDualSectorStorage<Offsets>(&SPIFlash::Inst(), SPI_FLASH_OFFSETS_SDSS_START_ADDR);
     offsetsStorage_->Read(currentOffsets_);
 
     while (1) {
@@ -178,6 +183,17 @@ bool FlashTask::ReadLogDataFromFlash()
             SOAR_PRINT("%3d %08d   %04d   %04d\n",
                 length, baroRead->time, baroRead->pressure_, baroRead->temperature_);
         }
+        else if (length == sizeof(IMUBatchData)) {
+            uint8_t dataRead[sizeof(IMUBatchData)];
+            W25qxx_ReadBytes(dataRead, SPI_FLASH_LOGGING_STORAGE_START_ADDR + i + 1, sizeof(IMUBatchData));
+            IMUBatchData* batchRead = (IMUBatchData*)dataRead;
+            SOAR_PRINT("%03d %08d   %d Hz   %d samples   flags %d\n",
+                length, batchRead->time, batchRead->odrHz, batchRead->count, batchRead->flags);
+            for (uint8_t s = 0; s < batchRead->count && s < IMU_BATCH_MAX_SAMPLES; s++) {
+                const int16_t* raw = batchRead->samples[s];
+                SOAR_PRINT("    %06d   %06d   %06d   %06d   %06d   %06d\n", raw[0], raw[1], raw[2], raw[3], raw[4], raw[5]);
+            }
+        }
         else {
             SOAR_PRINT("Unknown length, readback brokedown: %d\n", length);
         }
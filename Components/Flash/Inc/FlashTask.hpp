@@ -28,8 +28,7 @@ class FlashTask : public Task
 {
 public:
     static FlashTask& Inst() {
-        static FlashTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
@@ -53,6 +52,8 @@ private:
     FlashTask(const FlashTask&);                        // Prevent copy-construction
     FlashTask& operator=(const FlashTask&);            // Prevent assignment
 
+    static FlashTask inst_;    // Singleton instance, defined in the .cpp
+
     // Offsets
     struct Offsets
     {
@@ -61,8 +62,13 @@ private:
 
     Offsets currentOffsets_;
     SimpleDualSectorStorage<Offsets>* offsetsStorage_;
+    alignas(SimpleDualSectorStorage<Offsets>) uint8_t offsetsStorageMem_[sizeof(SimpleDualSectorStorage<Offsets>)];    // Constructed in Run() once the flash is initialized
 
     uint8_t writesSinceLastOffsetUpdate_;
+
+    // Static storage
+    StaticQueue<FLASH_TASK_QUEUE_DEPTH_OBJS, FLASH_TASK_PRIORITY_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage
+    TaskStorage<FLASH_TASK_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_FLASHTASK_HPP_
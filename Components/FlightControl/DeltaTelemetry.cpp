@@ -0,0 +1,79 @@
+/**
+ ******************************************************************************
+ * File Name          : DeltaTelemetry.cpp
+ * Description        : Compact delta and varint encoding for the high-rate IMU and
+ *    barometer telemetry streams, sent beside the protobuf telemetry messages.
+ ******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "DeltaTelemetry.hpp"
+#include "DMBProtocolTask.hpp"
+
+static_assert(DeltaFrameEncoder<DELTA_IMU_NUM_VALUES>::MAX_FRAME_SIZE <= DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE, "IMU delta frame does not fit in a protocol write buffer");
+static_assert(TELEMETRY_DELTA_MSG_ID != static_cast<uint8_t>(Proto::MessageID::MSG_COMMAND) &&
+              TELEMETRY_DELTA_MSG_ID != static_cast<uint8_t>(Proto::MessageID::MSG_CONTROL) &&
+              TELEMETRY_DELTA_MSG_ID != static_cast<uint8_t>(Proto::MessageID::MSG_TELEMETRY), "Delta frame ID collides with a protobuf message ID");
+
+/* Static Variable Init ------------------------------------------------------*/
+bool DeltaTelemetry::enabled_ = TELEMETRY_DELTA_ENCODING_ENABLED;
+DeltaFrameEncoder<DELTA_IMU_NUM_VALUES> DeltaTelemetry::imuEncoder_(DELTA_STREAM_IMU, TELEMETRY_DELTA_KEYFRAME_INTERVAL);
+DeltaFrameEncoder<DELTA_BARO_NUM_VALUES> DeltaTelemetry::baroEncoder_(DELTA_STREAM_BARO, TELEMETRY_DELTA_KEYFRAME_INTERVAL);
+
+/* Functions -----------------------------------------------------------------*/
+/**
+ * @brief Enables or disables delta frames, each stream restarts with a keyframe when enabled.
+ *        Called from the debug task, the keyframe is only requested here and the owning sensor task sends it.
+ */
+void DeltaTelemetry::SetEnabled(bool enabled)
+{
+    if (enabled && !enabled_) {
+        imuEncoder_.ForceKeyframe();
+        baroEncoder_.ForceKeyframe();
+    }
+    enabled_ = enabled;
+}
+
+/**
+ * @brief Sends an IMU sample as the next frame of the IMU stream, called from the IMU task only
+ */
+void DeltaTelemetry::SendIMU(const AccelGyroMagnetismData& imu)
+{
+    const int32_t values[DELTA_IMU_NUM_VALUES] = {
+        imu.accelX_, imu.accelY_, imu.accelZ_,
+        imu.gyroX_, imu.gyroY_, imu.gyroZ_,
+        imu.magnetoX_, imu.magnetoY_, imu.magnetoZ_
+    };
+
+    uint8_t frame[DeltaFrameEncoder<DELTA_IMU_NUM_VALUES>::MAX_FRAME_SIZE];
+    uint16_t len = imuEncoder_.Encode(values, (uint32_t)imu.time, frame);
+
+    // The ground side cannot decode deltas against a frame it never got
+    if (!SendFrame(frame, len))
+        imuEncoder_.ForceKeyframe();
+}
+
+/**
+ * @brief Sends a barometer sample as the next frame of the barometer stream, called from the barometer task only
+ */
+void DeltaTelemetry::SendBaro(const BarometerData& baro)
+{
+    const int32_t values[DELTA_BARO_NUM_VALUES] = { baro.pressure_, baro.temperature_ };
+
+    uint8_t frame[DeltaFrameEncoder<DELTA_BARO_NUM_VALUES>::MAX_FRAME_SIZE];
+    uint16_t len = baroEncoder_.Encode(values, (uint32_t)baro.time, frame);
+
+    if (!SendFrame(frame, len))
+        baroEncoder_.ForceKeyframe();
+}
+
+/**
+ * @brief Sends an encoded frame over the radio as a sensor message
+ * @return false if the frame was dropped by the radio link budget
+ */
+bool DeltaTelemetry::SendFrame(const uint8_t* frame, uint16_t size)
+{
+    EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE> writeBuffer;
+    writeBuffer.push(frame, size);
+
+    return DMBProtocolTask::SendProtobufMessage(writeBuffer, static_cast<Proto::MessageID>(TELEMETRY_DELTA_MSG_ID), RADIO_MSG_CLASS_SENSOR_HIGH_RATE);
+}
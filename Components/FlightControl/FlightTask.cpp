@@ -13,10 +13,15 @@
 #include "SystemStorage.hpp"
 #include "RocketSM.hpp"
 
+#include <new>         // Support for placement new
+
+/* Static Variable Init ------------------------------------------------------------------*/
+FlightTask FlightTask::inst_;
+
 /**
  * @brief Constructor for FlightTask
  */
-FlightTask::FlightTask() : Task(FLIGHT_TASK_QUEUE_DEPTH_OBJS)
+FlightTask::FlightTask() : Task(&evtQueue_)
 {
     rsm_ = nullptr;
 }
@@ -29,15 +34,16 @@ void FlightTask::InitTask()
     // Make sure the task is not already initialized
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize flight task twice");
     
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)FlightTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)FlightTask::RunTask,
             (const char*)"FlightTask",
-            (uint16_t)FLIGHT_TASK_STACK_DEPTH_WORDS,
+            (uint32_t)FLIGHT_TASK_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)FLIGHT_TASK_RTOS_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
-    SOAR_ASSERT(rtValue == pdPASS, "FlightTask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "FlightTask::InitTask() - xTaskCreateStatic() failed");
 }
 
 /**
@@ -65,14 +71,14 @@ void FlightTask::Run(void * pvParams)
             sysState.rocketState = RS_ABORT;
         }
 
-        rsm_ = new RocketSM(sysState.rocketState, true);
+        rsm_ = new (rsmStorage_) RocketSM(sysState.rocketState, true);
     }
     else {
         // Failed to read state, start in default state
         //TODO: Should implement a backup SimpleSectorStorage that is written to/read only once
         //TODO: where after the LAUNCH state, the default state becomes RS_COAST (or whatever is safest)
         //TODO: based on a unique key being written to the SSStorage
-        rsm_ = new RocketSM(RS_ABORT, true);
+        rsm_ = new (rsmStorage_) RocketSM(RS_ABORT, true);
     }
 
     while (1) {
@@ -169,5 +175,5 @@ void FlightTask::SendRocketState()
     msg.serialize(writeBuffer);
 
     // Send the control message
-    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_CONTROL);
+    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_CONTROL, RADIO_MSG_CLASS_STATE);
 }
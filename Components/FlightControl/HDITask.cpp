@@ -13,6 +13,8 @@
 #include "Command.hpp"
 #include "etl/map.h"
 
+/* Static Variable Init ------------------------------------------------------------------*/
+HDITask HDITask::inst_;
 
 extern TIM_HandleTypeDef htim2;
 constexpr uint16_t BUZZER_DEFAULT_DUTY_CYCLE = 190;
@@ -52,7 +54,7 @@ etl::map<RocketState, HDIConfig, 11> stateBlinks = etl::map<RocketState, HDIConf
 /**
 * @brief Constructor for HDITask
 */
-HDITask::HDITask():Task(HDI_TASK_QUEUE_DEPTH_OBJS), buzzerMuted_(false)
+HDITask::HDITask():Task(&evtQueue_), buzzerMuted_(false)
 {
 }
 
@@ -64,15 +66,16 @@ void HDITask::InitTask()
     // Make sure the task is not already initialized
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize HDI task twice");
 
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)HDITask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)HDITask::RunTask,
             (const char*)"HDITask",
-            (uint16_t)HDI_TASK_STACK_DEPTH_WORDS,
+            (uint32_t)HDI_TASK_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)HDI_TASK_RTOS_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
-    SOAR_ASSERT(rtValue == pdPASS, "HDITask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "HDITask::InitTask() - xTaskCreateStatic() failed");
 }
 
 
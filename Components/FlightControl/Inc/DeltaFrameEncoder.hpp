@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * File Name          : DeltaFrameEncoder.hpp
+ * Description        : Delta and varint frame encoder for one telemetry stream,
+ *    hardware independent so it can be tested on the host.
+ ******************************************************************************
+*/
+#ifndef SOAR_DELTA_FRAME_ENCODER_HPP_
+#define SOAR_DELTA_FRAME_ENCODER_HPP_
+/* Includes ------------------------------------------------------------------*/
+#include <cstdint>
+
+/* Macros ------------------------------------------------------------------*/
+constexpr uint8_t DELTA_FRAME_KEYFRAME_FLAG = 0x80;      // Set in the frame header byte on keyframes
+constexpr uint8_t DELTA_FRAME_HEADER_SIZE = 3;           // Header byte and sequence number
+constexpr uint8_t DELTA_VARINT_MAX_BYTES = 5;            // Longest varint of a 32 bit value
+
+/*
+ * Frame layout:
+ *  uint8   header, bits 0-6 stream ID (DELTA_STREAM_ID in DeltaTelemetry.hpp), bit 7 set on keyframes
+ *  uint16  sequence number (little-endian), per stream, incremented on every frame
+ *  varint  keyframe : timestamp (ms)          delta : ms since the previous frame
+ *  zigzag varint per value
+ *          keyframe : the value                delta : value - previous value (wrapping 32 bit arithmetic)
+ *
+ * Varints are little-endian base 128, the top bit of each byte is set if another byte follows.
+ * Zig-zag maps signed values to unsigned so small negative deltas stay short: 0, -1, 1, -2 -> 0, 1, 2, 3.
+ *
+ * A delta frame can only be decoded against the frame right before it, so the ground side must drop
+ * delta frames after a gap in the sequence number until the next keyframe of that stream.
+ */
+
+/* Class -----------------------------------------------------------------*/
+/**
+ * @brief Encoder state for one delta stream, keeps the previous frame to delta against.
+ *        Each stream must only be encoded by one task, ForceKeyframe() may be called from any task.
+ */
+template<uint8_t NUM_VALUES>
+class DeltaFrameEncoder
+{
+public:
+    static constexpr uint16_t MAX_FRAME_SIZE = DELTA_FRAME_HEADER_SIZE + DELTA_VARINT_MAX_BYTES * (1 + NUM_VALUES);
+
+    DeltaFrameEncoder(uint8_t streamId, uint16_t keyframeInterval)
+        : streamId_(streamId), keyframeInterval_(keyframeInterval), sequence_(0),
+          framesSinceKeyframe_(keyframeInterval), keyframeRequested_(false), prevTimestampMs_(0), prev_() {}
+
+    /**
+     * @brief Encodes the next frame of the stream
+     * @param values Current values of the stream
+     * @param timestampMs Sample time of the values
+     * @param out Output buffer, must hold at least MAX_FRAME_SIZE bytes
+     * @return Size of the encoded frame in bytes
+     */
+    uint16_t Encode(const int32_t (&values)[NUM_VALUES], uint32_t timestampMs, uint8_t* out)
+    {
+        bool isKeyframe = (framesSinceKeyframe_ >= keyframeInterval_);
+
+        // Cleared before this frame is encoded, so a request that arrives meanwhile is still met by this keyframe
+        if (keyframeRequested_) {
+            keyframeRequested_ = false;
+            isKeyframe = true;
+        }
+        uint8_t* pos = out;
+
+        *pos++ = streamId_ | (isKeyframe ? DELTA_FRAME_KEYFRAME_FLAG : 0);
+        *pos++ = (uint8_t)sequence_;
+        *pos++ = (uint8_t)(sequence_ >> 8);
+
+        pos = PutVarint(pos, isKeyframe ? timestampMs : timestampMs - prevTimestampMs_);
+        for (uint8_t i = 0; i < NUM_VALUES; i++) {
+            int32_t v = isKeyframe ? values[i] : (int32_t)((uint32_t)values[i] - (uint32_t)prev_[i]);
+            pos = PutVarint(pos, ZigZag(v));
+            prev_[i] = values[i];
+        }
+
+        prevTimestampMs_ = timestampMs;
+        framesSinceKeyframe_ = isKeyframe ? 1 : framesSinceKeyframe_ + 1;
+        sequence_++;
+        return (uint16_t)(pos - out);
+    }
+
+    void ForceKeyframe() { keyframeRequested_ = true; }    // Makes the next frame a keyframe, eg. after it was lost on our side
+
+private:
+    static inline uint32_t ZigZag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+
+    static inline uint8_t* PutVarint(uint8_t* out, uint32_t v)
+    {
+        while (v >= 0x80) {
+            *out++ = (uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        *out++ = (uint8_t)v;
+        return out;
+    }
+
+    const uint8_t streamId_;
+    const uint16_t keyframeInterval_;    // A keyframe is sent at least every this many frames
+    uint16_t sequence_;                  // Sequence number of the next frame
+    uint16_t framesSinceKeyframe_;       // Frames sent since the last keyframe, the next frame is a keyframe when this reaches the interval
+    volatile bool keyframeRequested_;    // Set by ForceKeyframe() from any task, only Encode() clears it
+    uint32_t prevTimestampMs_;
+    int32_t prev_[NUM_VALUES];           // Values of the previous frame
+};
+
+#endif    // SOAR_DELTA_FRAME_ENCODER_HPP_
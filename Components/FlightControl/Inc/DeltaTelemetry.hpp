@@ -0,0 +1,49 @@
+/**
+ ******************************************************************************
+ * File Name          : DeltaTelemetry.hpp
+ * Description        : Compact delta and varint encoding for the high-rate IMU and
+ *    barometer telemetry streams, sent beside the protobuf telemetry messages.
+ ******************************************************************************
+*/
+#ifndef SOAR_DELTA_TELEMETRY_HPP_
+#define SOAR_DELTA_TELEMETRY_HPP_
+/* Includes ------------------------------------------------------------------*/
+#include "Data.h"
+#include "SystemDefines.hpp"
+#include "DeltaFrameEncoder.hpp"
+
+/* Macros ------------------------------------------------------------------*/
+constexpr uint8_t TELEMETRY_DELTA_MSG_ID = 0x21;         // Protocol message ID of delta frames, outside the protobuf message IDs (see Documentation/Osprey/Communication Overview/RadioFrames.md)
+
+enum DELTA_STREAM_ID {
+    DELTA_STREAM_IMU = 1,     // accel x/y/z, gyro x/y/z, mag x/y/z
+    DELTA_STREAM_BARO = 2,    // pressure, temperature
+};
+
+constexpr uint8_t DELTA_IMU_NUM_VALUES = 9;
+constexpr uint8_t DELTA_BARO_NUM_VALUES = 2;
+
+/* Class -----------------------------------------------------------------*/
+/**
+ * @brief Sends the IMU and barometer samples as delta frames in place of their protobuf messages when enabled.
+ */
+class DeltaTelemetry
+{
+public:
+    static bool IsEnabled() { return enabled_; }
+    static void SetEnabled(bool enabled);
+
+    // Called by the sensor tasks in place of their protocol transmit when enabled
+    static void SendIMU(const AccelGyroMagnetismData& imu);
+    static void SendBaro(const BarometerData& baro);
+
+private:
+    static bool SendFrame(const uint8_t* frame, uint16_t size);    // Returns false if the frame was dropped by the radio link budget
+
+    static bool enabled_;    // True if the sensor tasks should send delta frames instead of protobuf messages
+
+    static DeltaFrameEncoder<DELTA_IMU_NUM_VALUES> imuEncoder_;
+    static DeltaFrameEncoder<DELTA_BARO_NUM_VALUES> baroEncoder_;
+};
+
+#endif    // SOAR_DELTA_TELEMETRY_HPP_
@@ -21,8 +21,7 @@ class FlightTask : public Task
 {
 public:
     static FlightTask& Inst() {
-        static FlightTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
@@ -42,8 +41,15 @@ private:
     FlightTask(const FlightTask&);                        // Prevent copy-construction
     FlightTask& operator=(const FlightTask&);            // Prevent assignment
 
+    static FlightTask inst_;    // Singleton instance, defined in the .cpp
+
     // Private Variables
     RocketSM* rsm_;
+    alignas(RocketSM) uint8_t rsmStorage_[sizeof(RocketSM)];    // Constructed in Run() once the starting state is read from flash
+
+    // Static storage
+    StaticQueue<FLIGHT_TASK_QUEUE_DEPTH_OBJS, FLIGHT_TASK_PRIORITY_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage
+    TaskStorage<FLIGHT_TASK_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_FLIGHTTASK_HPP_
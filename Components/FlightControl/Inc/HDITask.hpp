@@ -26,8 +26,7 @@ class HDITask : public Task
 {
 public:
     static HDITask& Inst() {
-        static HDITask inst;
-        return inst;
+        return inst_;
     }
     void InitTask();
     RocketState currentHDIState();
@@ -45,10 +44,16 @@ private:
     HDITask();        // Private constructor
     HDITask(const HDITask&);                        // Prevent copy-construction
     HDITask& operator=(const HDITask&);            // Prevent assignment
+
+    static HDITask inst_;    // Singleton instance, defined in the .cpp
     HDIConfig currentConfig;
 
     bool buzzerMuted_;
 
+
+    // Static storage
+    StaticQueue<HDI_TASK_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage
+    TaskStorage<HDI_TASK_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_FLIGHTTASK_HPP_
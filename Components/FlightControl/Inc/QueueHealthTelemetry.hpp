@@ -0,0 +1,73 @@
+/**
+ ******************************************************************************
+ * File Name          : QueueHealthTelemetry.hpp
+ * Description        : Compact per-queue health frame for the downlink, so queue
+ *    backlog and drops are visible on the ground without the debug UART.
+ ******************************************************************************
+*/
+#ifndef SOAR_QUEUE_HEALTH_TELEMETRY_HPP_
+#define SOAR_QUEUE_HEALTH_TELEMETRY_HPP_
+/* Includes ------------------------------------------------------------------*/
+#include "Queue.hpp"
+#include "SystemDefines.hpp"
+
+/* Macros ------------------------------------------------------------------*/
+constexpr uint8_t QUEUE_HEALTH_FRAME_VERSION = 1;       // Bumped whenever the frame layout or queue order changes
+constexpr uint8_t QUEUE_HEALTH_MSG_ID = 0x22;           // Protocol message ID of the frame, outside the protobuf message IDs (see Documentation/Osprey/Communication Overview/RadioFrames.md)
+constexpr uint8_t QUEUE_HEALTH_HEADER_SIZE = 6;
+constexpr uint8_t QUEUE_HEALTH_ENTRY_SIZE = 4;
+
+/*
+ * Frame layout, all values little-endian:
+ *  uint8   version
+ *  uint8   number of queues that follow
+ *  uint32  timestamp (ms)
+ *  per queue, in TELEMETRY_QUEUE order:
+ *  uint8   depth high watermark since boot (both lanes)
+ *  uint16  failed sends plus commands dropped to make space, since boot, wraps
+ *  uint8   highest latency histogram bin with a sample, 0 is 0 ticks, N is [2^(N-1), 2^N) ticks
+ */
+enum TELEMETRY_QUEUE {
+    TELEMETRY_QUEUE_FLIGHT = 0,
+    TELEMETRY_QUEUE_UART,
+    TELEMETRY_QUEUE_UART_DEBUG_TX,
+    TELEMETRY_QUEUE_UART_RADIO_TX,
+    TELEMETRY_QUEUE_UART_PBB_TX,
+    TELEMETRY_QUEUE_DEBUG,
+    TELEMETRY_QUEUE_FLASH,
+    TELEMETRY_QUEUE_WATCHDOG,
+    TELEMETRY_QUEUE_TELEMETRY,
+    TELEMETRY_QUEUE_HDI,
+    TELEMETRY_QUEUE_BARO,
+    TELEMETRY_QUEUE_IMU,
+    TELEMETRY_QUEUE_PT,
+    TELEMETRY_QUEUE_BATTERY,
+    TELEMETRY_QUEUE_GPS,
+    TELEMETRY_QUEUE_DMB_PROTOCOL,
+    TELEMETRY_QUEUE_PBB_RX_PROTOCOL,
+    TELEMETRY_QUEUE_COUNT
+};
+
+constexpr uint16_t QUEUE_HEALTH_FRAME_SIZE_BYTES = QUEUE_HEALTH_HEADER_SIZE + QUEUE_HEALTH_ENTRY_SIZE * TELEMETRY_QUEUE_COUNT;
+
+/* Class -----------------------------------------------------------------*/
+/**
+ * @brief Sends the health of every task queue as one frame, TelemetryTask calls SendFrame() every
+ *        TELEMETRY_QUEUE_HEALTH_LOG_PERIODS log sequences when enabled.
+ */
+class QueueHealthTelemetry
+{
+public:
+    static bool IsEnabled() { return enabled_; }
+    static void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+    static void SendFrame();
+
+    static const Queue* GetQueue(TELEMETRY_QUEUE queue);
+    static const char* GetQueueName(TELEMETRY_QUEUE queue);
+
+private:
+    static bool enabled_;    // True if TelemetryTask should send queue health frames
+};
+
+#endif    // SOAR_QUEUE_HEALTH_TELEMETRY_HPP_
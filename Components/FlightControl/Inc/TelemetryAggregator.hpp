@@ -0,0 +1,92 @@
+/**
+ ******************************************************************************
+ * File Name          : TelemetryAggregator.hpp
+ * Description        : Collects the latest sensor and valve values into one compact
+ *    telemetry frame per logging period, instead of one protobuf message per sensor.
+ ******************************************************************************
+*/
+#ifndef SOAR_TELEMETRY_AGGREGATOR_HPP_
+#define SOAR_TELEMETRY_AGGREGATOR_HPP_
+/* Includes ------------------------------------------------------------------*/
+#include "Data.h"
+#include "SystemDefines.hpp"
+
+/* Macros ------------------------------------------------------------------*/
+constexpr uint8_t TELEMETRY_FRAME_VERSION = 1;        // Bumped whenever the frame layout changes
+constexpr uint8_t TELEMETRY_FRAME_MSG_ID = 0x20;      // Protocol message ID of the frame, outside the protobuf message IDs (see Documentation/Osprey/Communication Overview/RadioFrames.md)
+
+/*
+ * Frame layout, all values little-endian, fields only present if their bit is set in the field mask:
+ *  uint8   version
+ *  uint8   field mask (TELEMETRY_FRAME_FIELD)
+ *  uint16  sequence number
+ *  uint32  snapshot timestamp (ms), time the sensors were asked for the values in this frame
+ *  Baro        : int32 pressure, int32 temperature
+ *  IMU         : int32 accel x/y/z, gyro x/y/z, mag x/y/z
+ *  PT          : int32 pressure
+ *  Battery     : int32 voltage, uint8 power source (1 = rocket, 0 = ground)
+ *  GPS         : uint32 time, int32 lat degrees, lat minutes, long degrees, long minutes,
+ *                int32 antenna altitude, geoid altitude, total altitude
+ *  Combustion  : uint8 bit 0 vent open, bit 1 drain open, bit 2 MEV open
+ */
+enum TELEMETRY_FRAME_FIELD {
+    TELEMETRY_FRAME_FIELD_BARO = 0x01,
+    TELEMETRY_FRAME_FIELD_IMU = 0x02,
+    TELEMETRY_FRAME_FIELD_PT = 0x04,
+    TELEMETRY_FRAME_FIELD_BATTERY = 0x08,
+    TELEMETRY_FRAME_FIELD_GPS = 0x10,
+    TELEMETRY_FRAME_FIELD_COMBUSTION = 0x20,
+};
+
+constexpr uint16_t TELEMETRY_FRAME_MAX_SIZE_BYTES = 8 + 8 + 36 + 4 + 5 + 32 + 1;    // Header and every field
+
+/* Class -----------------------------------------------------------------*/
+/**
+ * @brief Snapshot of the values published by the sensor tasks during one logging period.
+ *
+ * At the start of each log sequence TelemetryTask calls SendFrame(), which sends the values published during the
+ * previous period as one frame and opens a new snapshot. Sensors that did not publish in a period are left out of its frame.
+ */
+class TelemetryAggregator
+{
+public:
+    static bool IsEnabled() { return enabled_; }
+    static void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+    // Called by the sensor tasks in place of their protocol transmit when enabled
+    static void UpdateBaro(const BarometerData& baro);
+    static void UpdateIMU(const AccelGyroMagnetismData& imu);
+    static void UpdatePressureTransducer(const PressureTransducerData& pt);
+    static void UpdateBattery(const BatteryData& battery, bool isRocketPower);
+    static void UpdateGPS(const GpsData& gps);
+    static void UpdateCombustionControl(bool ventOpen, bool drainOpen, bool mevOpen);
+
+    static void SendFrame();    // Sends the current snapshot if it has any fields and starts the next one
+
+private:
+    struct Snapshot
+    {
+        uint8_t fieldMask;
+        uint32_t timestampMs;
+        BarometerData baro;
+        AccelGyroMagnetismData imu;
+        PressureTransducerData pt;
+        BatteryData battery;
+        bool isRocketPower;
+        uint32_t gpsTime;
+        LatLongType latitude;
+        LatLongType longitude;
+        int32_t antennaAltitude;
+        int32_t geoidAltitude;
+        int32_t totalAltitude;
+        uint8_t combustionFlags;
+    };
+
+    static uint16_t Serialize(const Snapshot& snapshot, uint8_t* out);
+
+    static bool enabled_;            // True if TelemetryTask should send frames instead of per-sensor messages
+    static uint16_t sequence_;       // Sequence number of the next frame
+    static Snapshot current_;        // Snapshot being filled during this period
+};
+
+#endif    // SOAR_TELEMETRY_AGGREGATOR_HPP_
@@ -16,8 +16,7 @@ class TelemetryTask : public Task
 {
 public:
     static TelemetryTask& Inst() {
-        static TelemetryTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
@@ -33,6 +32,7 @@ protected:
     void RequestSample();
     void RequestTransmit();
     void RequestLogToFlash();
+    void SendRequest(Task& sensor, uint16_t request);
 
     void SendVentDrainStatus();
 
@@ -43,10 +43,17 @@ private:
     TelemetryTask(const TelemetryTask&);                        // Prevent copy-construction
     TelemetryTask& operator=(const TelemetryTask&);            // Prevent assignment
 
+    static TelemetryTask inst_;    // Singleton instance, defined in the .cpp
+
     // Private Variables
     uint32_t loggingDelayMs;
 
     uint8_t numNonFlashLogs_;
+    uint8_t numLogsSinceQueueHealth_;
+
+    // Static storage
+    StaticQueue<TELEMETRY_TASK_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage
+    TaskStorage<TELEMETRY_TASK_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_TELEMETRYTASK_HPP_
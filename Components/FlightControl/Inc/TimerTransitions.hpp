@@ -56,10 +56,10 @@ protected:
 
 private:
     Timer* ignitionCountdown;
-    Timer* burnCountdown;
-    Timer* coastCountdown;
-    Timer* descentCountdown;
-    Timer* recoveryCountdown;
+    Timer burnCountdown;
+    Timer coastCountdown;
+    Timer descentCountdown;
+    Timer recoveryCountdown;
 };
 
 #endif    // SOAR_TIMERTRANSITIONS_HPP_
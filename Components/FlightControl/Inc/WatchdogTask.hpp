@@ -22,8 +22,7 @@ class WatchdogTask : public Task
 {
 public:
     static WatchdogTask& Inst() {
-        static WatchdogTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
@@ -36,13 +35,19 @@ protected:
     static void HeartbeatFailureCallback(TimerHandle_t rtTimerHandle);    // Callback for timer which aborts system in case of data ghosting
     void HandleCommand(Command& cm);
     void HandleHeartbeat(uint16_t taskCommand);                        // If it receives a heartbeat then it resets the timer
-    Timer* heartbeatTimer;
+    Timer heartbeatTimer;
 
 private:
     // Private Functions
     WatchdogTask();        // Private constructor
     WatchdogTask(const WatchdogTask&);                        // Prevent copy-construction
     WatchdogTask& operator=(const WatchdogTask&);            // Prevent assignment
+
+    static WatchdogTask inst_;    // Singleton instance, defined in the .cpp
+
+    // Static storage
+    StaticQueue<WATCHDOG_TASK_QUEUE_DEPTH_OBJS, WATCHDOG_TASK_PRIORITY_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage
+    TaskStorage<WATCHDOG_TASK_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_WATCHDOGTASK_HPP_
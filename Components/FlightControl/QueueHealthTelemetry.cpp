@@ -0,0 +1,112 @@
+/**
+ ******************************************************************************
+ * File Name          : QueueHealthTelemetry.cpp
+ * Description        : Compact per-queue health frame for the downlink, so queue
+ *    backlog and drops are visible on the ground without the debug UART.
+ ******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "QueueHealthTelemetry.hpp"
+#include "DMBProtocolTask.hpp"
+
+#include "FlightTask.hpp"
+#include "UARTTask.hpp"
+#include "DebugTask.hpp"
+#include "FlashTask.hpp"
+#include "WatchdogTask.hpp"
+#include "TelemetryTask.hpp"
+#include "HDITask.hpp"
+#include "BarometerTask.hpp"
+#include "IMUTask.hpp"
+#include "PressureTransducerTask.hpp"
+#include "BatteryTask.hpp"
+#include "GPSTask.hpp"
+#include "PBBRxProtocolTask.hpp"
+
+static_assert(QUEUE_HEALTH_FRAME_SIZE_BYTES <= DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE, "Queue health frame does not fit in a protocol write buffer");
+static_assert(QUEUE_HEALTH_MSG_ID != static_cast<uint8_t>(Proto::MessageID::MSG_COMMAND) &&
+              QUEUE_HEALTH_MSG_ID != static_cast<uint8_t>(Proto::MessageID::MSG_CONTROL) &&
+              QUEUE_HEALTH_MSG_ID != static_cast<uint8_t>(Proto::MessageID::MSG_TELEMETRY), "Queue health frame ID collides with a protobuf message ID");
+
+/* Static Variable Init ------------------------------------------------------*/
+bool QueueHealthTelemetry::enabled_ = TELEMETRY_QUEUE_HEALTH_ENABLED;
+
+static const char* const QUEUE_NAMES[TELEMETRY_QUEUE_COUNT] = {
+    "Flight", "UART", "UARTDebugTx", "UARTRadioTx", "UARTPBBTx", "Debug", "Flash", "Watchdog", "Telemetry",
+    "HDI", "Baro", "IMU", "PT", "Battery", "GPS", "DMBProto", "PBBRxProto"
+};
+
+/* Functions -----------------------------------------------------------------*/
+/**
+ * @brief Gets the queue reported at the given position of the frame
+ */
+const Queue* QueueHealthTelemetry::GetQueue(TELEMETRY_QUEUE queue)
+{
+    switch (queue) {
+    case TELEMETRY_QUEUE_FLIGHT: return FlightTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_UART: return UARTTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_UART_DEBUG_TX: return UARTTask::Inst().GetChannelQueue(UART_TASK_CHANNEL_DEBUG);
+    case TELEMETRY_QUEUE_UART_RADIO_TX: return UARTTask::Inst().GetChannelQueue(UART_TASK_CHANNEL_RADIO);
+    case TELEMETRY_QUEUE_UART_PBB_TX: return UARTTask::Inst().GetChannelQueue(UART_TASK_CHANNEL_PBB);
+    case TELEMETRY_QUEUE_DEBUG: return DebugTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_FLASH: return FlashTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_WATCHDOG: return WatchdogTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_TELEMETRY: return TelemetryTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_HDI: return HDITask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_BARO: return BarometerTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_IMU: return IMUTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_PT: return PressureTransducerTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_BATTERY: return BatteryTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_GPS: return GPSTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_DMB_PROTOCOL: return DMBProtocolTask::Inst().GetEventQueue();
+    case TELEMETRY_QUEUE_PBB_RX_PROTOCOL: return PBBRxProtocolTask::Inst().GetEventQueue();
+    default: return nullptr;
+    }
+}
+
+/**
+ * @brief Gets the short name of a queue, as printed by the queuestats debug command
+ */
+const char* QueueHealthTelemetry::GetQueueName(TELEMETRY_QUEUE queue)
+{
+    return (queue < TELEMETRY_QUEUE_COUNT) ? QUEUE_NAMES[queue] : "Unknown";
+}
+
+/**
+ * @brief Sends the health of every queue as one frame, in the layout described in QueueHealthTelemetry.hpp
+ */
+void QueueHealthTelemetry::SendFrame()
+{
+    uint8_t frame[QUEUE_HEALTH_FRAME_SIZE_BYTES];
+    uint8_t* p = frame;
+    uint32_t timestampMs = TICKS_TO_MS(xTaskGetTickCount());
+
+    *p++ = QUEUE_HEALTH_FRAME_VERSION;
+    *p++ = TELEMETRY_QUEUE_COUNT;
+    *p++ = (uint8_t)timestampMs;
+    *p++ = (uint8_t)(timestampMs >> 8);
+    *p++ = (uint8_t)(timestampMs >> 16);
+    *p++ = (uint8_t)(timestampMs >> 24);
+
+    for (uint8_t i = 0; i < TELEMETRY_QUEUE_COUNT; i++) {
+        QueueStats stats;
+        GetQueue((TELEMETRY_QUEUE)i)->GetStats(stats);
+
+        uint16_t drops = (uint16_t)(stats.failedSendCount + stats.droppedOldestCount);
+        uint8_t worstLatencyBin = 0;
+        for (uint8_t bin = 0; bin < QUEUE_LATENCY_HISTOGRAM_BINS; bin++) {
+            if (stats.latencyHistogram[bin] != 0)
+                worstLatencyBin = bin;
+        }
+
+        *p++ = (stats.depthHighWatermark > 0xFF) ? 0xFF : (uint8_t)stats.depthHighWatermark;
+        *p++ = (uint8_t)drops;
+        *p++ = (uint8_t)(drops >> 8);
+        *p++ = worstLatencyBin;
+    }
+
+    EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE> writeBuffer;
+    writeBuffer.push(frame, (uint16_t)(p - frame));
+
+    DMBProtocolTask::SendProtobufMessage(writeBuffer, static_cast<Proto::MessageID>(QUEUE_HEALTH_MSG_ID), RADIO_MSG_CLASS_SENSOR_LOW_RATE);
+}
@@ -15,6 +15,21 @@
 #include "FlashTask.hpp"
 #include "WatchdogTask.hpp"
 #include "MEVManager.hpp"
+#include "IMUTask.hpp"
+/* Static Storage ------------------------------------------------------------------*/
+// There is only ever one state machine, so each state has exactly one statically allocated instance
+static PreLaunch preLaunchState;
+static Fill fillState;
+static Arm armState;
+static Ignition ignitionState;
+static Launch launchState;
+static Burn burnState;
+static Coast coastState;
+static Descent descentState;
+static Recovery recoveryState;
+static Abort abortState;
+static Test testState;
+
 /* Rocket State Machine ------------------------------------------------------------------*/
 /**
  * @brief Default constructor for Rocket SM, initializes all states
@@ -22,17 +37,17 @@
 RocketSM::RocketSM(RocketState startingState, bool enterStartingState)
 {
     // Setup the internal array of states. Setup in order of enum.
-    stateArray[RS_PRELAUNCH] = new PreLaunch();
-    stateArray[RS_FILL] = new Fill();
-    stateArray[RS_ARM] = new Arm();
-    stateArray[RS_IGNITION] = new Ignition();
-    stateArray[RS_LAUNCH] = new Launch();
-    stateArray[RS_BURN] = new Burn();
-    stateArray[RS_COAST] = new Coast();
-    stateArray[RS_DESCENT] = new Descent();
-    stateArray[RS_RECOVERY] = new Recovery();
-    stateArray[RS_ABORT] = new Abort();
-    stateArray[RS_TEST] = new Test();
+    stateArray[RS_PRELAUNCH] = &preLaunchState;
+    stateArray[RS_FILL] = &fillState;
+    stateArray[RS_ARM] = &armState;
+    stateArray[RS_IGNITION] = &ignitionState;
+    stateArray[RS_LAUNCH] = &launchState;
+    stateArray[RS_BURN] = &burnState;
+    stateArray[RS_COAST] = &coastState;
+    stateArray[RS_DESCENT] = &descentState;
+    stateArray[RS_RECOVERY] = &recoveryState;
+    stateArray[RS_ABORT] = &abortState;
+    stateArray[RS_TEST] = &testState;
 
     // Verify all states are initialized AND state IDs are consistent
     HDITask::Inst().SendCommand(Command(REQUEST_COMMAND, RS_ABORT));
@@ -106,7 +121,7 @@ void RocketSM::HandleCommand(Command& cm)
         Command cmd(TASK_SPECIFIC_COMMAND, (uint16_t)WRITE_STATE_TO_FLASH);
         uint8_t state = nextRocketState;
         cmd.CopyDataToCommand(&state, 1);
-        FlashTask::Inst().GetEventQueue()->Send(cmd);
+        FlashTask::Inst().GetEventQueue()->SendPriority(cmd);
         
         TransitionState(nextRocketState);
     }
@@ -189,6 +204,9 @@ RocketState PreLaunch::OnEnter()
     // Make sure the MEV enable pin is off
     GPIO::MEV_EN::Off();
 
+    // Back to the ground IMU rate if a launch was stopped
+    IMUTask::Inst().SendPriorityCommand(Command(TASK_SPECIFIC_COMMAND, (uint16_t)IMU_SET_ODR_119));
+
     return rsStateID;
 }
 
@@ -560,6 +578,9 @@ RocketState Launch::OnEnter()
 	
 	MEVManager::OpenMEV();
 	TimerTransitions::Inst().BurnSequence();
+
+    // Capture the burn at the full IMU rate
+    IMUTask::Inst().SendPriorityCommand(Command(TASK_SPECIFIC_COMMAND, (uint16_t)IMU_SET_ODR_952));
     return rsStateID;
 }
 
@@ -708,6 +729,9 @@ RocketState Coast::OnEnter()
 
     // Start Descent Transition Timer (~25 seconds) : Should be well after apogee
 	TimerTransitions::Inst().DescentSequence();
+
+    // Burn is over, drop back to the default IMU rate
+    IMUTask::Inst().SendPriorityCommand(Command(TASK_SPECIFIC_COMMAND, (uint16_t)IMU_SET_ODR_119));
     return rsStateID;
 }
 
@@ -921,7 +945,7 @@ RocketState Abort::OnEnter()
  */
 RocketState Abort::OnExit()
 {
-    WatchdogTask::Inst().SendCommand(Command(HEARTBEAT_COMMAND, RADIOHB_REQUEST));
+    WatchdogTask::Inst().SendPriorityCommand(Command(HEARTBEAT_COMMAND, RADIOHB_REQUEST));
     return rsStateID;
 }
 
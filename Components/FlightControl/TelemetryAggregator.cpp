@@ -0,0 +1,193 @@
+/**
+ ******************************************************************************
+ * File Name          : TelemetryAggregator.cpp
+ * Description        : Collects the latest sensor and valve values into one compact
+ *    telemetry frame per logging period, instead of one protobuf message per sensor.
+ ******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "TelemetryAggregator.hpp"
+#include "DMBProtocolTask.hpp"
+
+static_assert(TELEMETRY_FRAME_MAX_SIZE_BYTES <= DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE, "Telemetry frame does not fit in a protocol write buffer");
+static_assert(TELEMETRY_FRAME_MSG_ID != static_cast<uint8_t>(Proto::MessageID::MSG_COMMAND) &&
+              TELEMETRY_FRAME_MSG_ID != static_cast<uint8_t>(Proto::MessageID::MSG_CONTROL) &&
+              TELEMETRY_FRAME_MSG_ID != static_cast<uint8_t>(Proto::MessageID::MSG_TELEMETRY), "Telemetry frame ID collides with a protobuf message ID");
+
+/* Static Variable Init ------------------------------------------------------*/
+bool TelemetryAggregator::enabled_ = TELEMETRY_AGGREGATED_FRAME_ENABLED;
+uint16_t TelemetryAggregator::sequence_ = 0;
+TelemetryAggregator::Snapshot TelemetryAggregator::current_ = {};
+
+/* Helpers -------------------------------------------------------------------*/
+/**
+ * @brief Writes a 32 bit value little-endian
+ * @return Pointer to the byte after the value
+ */
+static inline uint8_t* PutInt32(uint8_t* out, int32_t value)
+{
+    uint32_t v = (uint32_t)value;
+    out[0] = (uint8_t)v;
+    out[1] = (uint8_t)(v >> 8);
+    out[2] = (uint8_t)(v >> 16);
+    out[3] = (uint8_t)(v >> 24);
+    return out + 4;
+}
+
+/* Functions -----------------------------------------------------------------*/
+/**
+ * @brief Publishes the latest barometer sample
+ */
+void TelemetryAggregator::UpdateBaro(const BarometerData& baro)
+{
+    taskENTER_CRITICAL();
+    current_.baro = baro;
+    current_.fieldMask |= TELEMETRY_FRAME_FIELD_BARO;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Publishes the latest IMU sample
+ */
+void TelemetryAggregator::UpdateIMU(const AccelGyroMagnetismData& imu)
+{
+    taskENTER_CRITICAL();
+    current_.imu = imu;
+    current_.fieldMask |= TELEMETRY_FRAME_FIELD_IMU;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Publishes the latest pressure transducer sample
+ */
+void TelemetryAggregator::UpdatePressureTransducer(const PressureTransducerData& pt)
+{
+    taskENTER_CRITICAL();
+    current_.pt = pt;
+    current_.fieldMask |= TELEMETRY_FRAME_FIELD_PT;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Publishes the latest battery sample
+ * @param isRocketPower True if the system is running from the rocket battery rather than ground power
+ */
+void TelemetryAggregator::UpdateBattery(const BatteryData& battery, bool isRocketPower)
+{
+    taskENTER_CRITICAL();
+    current_.battery = battery;
+    current_.isRocketPower = isRocketPower;
+    current_.fieldMask |= TELEMETRY_FRAME_FIELD_BATTERY;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Publishes the latest parsed GPS fix, the raw NMEA buffer is not kept
+ */
+void TelemetryAggregator::UpdateGPS(const GpsData& gps)
+{
+    taskENTER_CRITICAL();
+    current_.gpsTime = gps.time_;
+    current_.latitude = gps.latitude_;
+    current_.longitude = gps.longitude_;
+    current_.antennaAltitude = gps.antennaAltitude_.altitude_;
+    current_.geoidAltitude = gps.geoidAltitude_.altitude_;
+    current_.totalAltitude = gps.totalAltitude_.altitude_;
+    current_.fieldMask |= TELEMETRY_FRAME_FIELD_GPS;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Publishes the vent, drain and MEV state
+ */
+void TelemetryAggregator::UpdateCombustionControl(bool ventOpen, bool drainOpen, bool mevOpen)
+{
+    uint8_t flags = (ventOpen ? 0x01 : 0) | (drainOpen ? 0x02 : 0) | (mevOpen ? 0x04 : 0);
+
+    taskENTER_CRITICAL();
+    current_.combustionFlags = flags;
+    current_.fieldMask |= TELEMETRY_FRAME_FIELD_COMBUSTION;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Sends everything published since the last call as one frame, then starts a new snapshot timestamped now
+ */
+void TelemetryAggregator::SendFrame()
+{
+    Snapshot snapshot;
+
+    taskENTER_CRITICAL();
+    snapshot = current_;
+    current_.fieldMask = 0;
+    current_.timestampMs = TICKS_TO_MS(xTaskGetTickCount());
+    taskEXIT_CRITICAL();
+
+    if (snapshot.fieldMask == 0)
+        return;
+
+    uint8_t frame[TELEMETRY_FRAME_MAX_SIZE_BYTES];
+    uint16_t len = Serialize(snapshot, frame);
+
+    EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE> writeBuffer;
+    writeBuffer.push(frame, len);
+
+    // The frame carries state as well as sensor data, so it is not dropped before the per-sensor messages would be
+    DMBProtocolTask::SendProtobufMessage(writeBuffer, static_cast<Proto::MessageID>(TELEMETRY_FRAME_MSG_ID), RADIO_MSG_CLASS_STATE);
+}
+
+/**
+ * @brief Serializes a snapshot into the frame layout described in TelemetryAggregator.hpp
+ * @param snapshot Snapshot to serialize
+ * @param out Buffer of at least TELEMETRY_FRAME_MAX_SIZE_BYTES
+ * @return Number of bytes written
+ */
+uint16_t TelemetryAggregator::Serialize(const Snapshot& snapshot, uint8_t* out)
+{
+    uint8_t* p = out;
+
+    *p++ = TELEMETRY_FRAME_VERSION;
+    *p++ = snapshot.fieldMask;
+    *p++ = (uint8_t)sequence_;
+    *p++ = (uint8_t)(sequence_ >> 8);
+    p = PutInt32(p, snapshot.timestampMs);
+    sequence_++;
+
+    if (snapshot.fieldMask & TELEMETRY_FRAME_FIELD_BARO) {
+        p = PutInt32(p, snapshot.baro.pressure_);
+        p = PutInt32(p, snapshot.baro.temperature_);
+    }
+    if (snapshot.fieldMask & TELEMETRY_FRAME_FIELD_IMU) {
+        p = PutInt32(p, snapshot.imu.accelX_);
+        p = PutInt32(p, snapshot.imu.accelY_);
+        p = PutInt32(p, snapshot.imu.accelZ_);
+        p = PutInt32(p, snapshot.imu.gyroX_);
+        p = PutInt32(p, snapshot.imu.gyroY_);
+        p = PutInt32(p, snapshot.imu.gyroZ_);
+        p = PutInt32(p, snapshot.imu.magnetoX_);
+        p = PutInt32(p, snapshot.imu.magnetoY_);
+        p = PutInt32(p, snapshot.imu.magnetoZ_);
+    }
+    if (snapshot.fieldMask & TELEMETRY_FRAME_FIELD_PT) {
+        p = PutInt32(p, snapshot.pt.pressure_1);
+    }
+    if (snapshot.fieldMask & TELEMETRY_FRAME_FIELD_BATTERY) {
+        p = PutInt32(p, snapshot.battery.voltage_);
+        *p++ = snapshot.isRocketPower ? 1 : 0;
+    }
+    if (snapshot.fieldMask & TELEMETRY_FRAME_FIELD_GPS) {
+        p = PutInt32(p, snapshot.gpsTime);
+        p = PutInt32(p, snapshot.latitude.degrees_);
+        p = PutInt32(p, snapshot.latitude.minutes_);
+        p = PutInt32(p, snapshot.longitude.degrees_);
+        p = PutInt32(p, snapshot.longitude.minutes_);
+        p = PutInt32(p, snapshot.antennaAltitude);
+        p = PutInt32(p, snapshot.geoidAltitude);
+        p = PutInt32(p, snapshot.totalAltitude);
+    }
+    if (snapshot.fieldMask & TELEMETRY_FRAME_FIELD_COMBUSTION) {
+        *p++ = snapshot.combustionFlags;
+    }
+
+    return (uint16_t)(p - out);
+}
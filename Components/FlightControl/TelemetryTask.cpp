@@ -8,6 +8,8 @@
 #include "GPIO.hpp"
 #include "SystemDefines.hpp"
 #include "DMBProtocolTask.hpp"
+#include "TelemetryAggregator.hpp"
+#include "QueueHealthTelemetry.hpp"
 
 #include "BarometerTask.hpp"
 #include "IMUTask.hpp"
@@ -16,13 +18,17 @@
 #include "BatteryTask.hpp"
 #include "GPSTask.hpp"
 
+/* Static Variable Init ------------------------------------------------------------------*/
+TelemetryTask TelemetryTask::inst_;
+
 /**
  * @brief Constructor for TelemetryTask
  */
-TelemetryTask::TelemetryTask() : Task(TELEMETRY_TASK_QUEUE_DEPTH_OBJS)
+TelemetryTask::TelemetryTask() : Task(&evtQueue_)
 {
     loggingDelayMs = TELEMETRY_DEFAULT_LOGGING_RATE_MS;
     numNonFlashLogs_ = 0;
+    numLogsSinceQueueHealth_ = 0;
 }
 
 /**
@@ -33,15 +39,16 @@ void TelemetryTask::InitTask()
     // Make sure the task is not already initialized
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize telemetry task twice");
 
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)TelemetryTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)TelemetryTask::RunTask,
             (const char*)"TelemetryTask",
-            (uint16_t)TELEMETRY_TASK_STACK_DEPTH_WORDS,
+            (uint32_t)TELEMETRY_TASK_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)TELEMETRY_TASK_RTOS_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
-    SOAR_ASSERT(rtValue == pdPASS, "TelemetryTask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "TelemetryTask::InitTask() - xTaskCreateStatic() failed");
 }
 
 /**
@@ -50,13 +57,20 @@ void TelemetryTask::InitTask()
  */
 void TelemetryTask::Run(void* pvParams)
 {
-    while (1) {
-        //Process all commands in queue this cycle
-        Command cm;
-		while (qEvtQueue->Receive(cm))
-            HandleCommand(cm);
+    Command batch[MAX_COMMAND_BATCH_SIZE];
+    uint32_t nextLogTick = xTaskGetTickCount() + MS_TO_TICKS(loggingDelayMs);
 
-        osDelay(loggingDelayMs);
+    while (1) {
+        //Handle commands in batches until the next log sequence is due
+        int32_t ticksToLog = (int32_t)(nextLogTick - xTaskGetTickCount());
+        if (ticksToLog > 0) {
+            uint16_t count = qEvtQueue->ReceiveBatch(batch, MAX_COMMAND_BATCH_SIZE, TICKS_TO_MS(ticksToLog));
+            for (uint16_t i = 0; i < count; i++)
+                HandleCommand(batch[i]);
+            continue;
+        }
+
+        nextLogTick = xTaskGetTickCount() + MS_TO_TICKS(loggingDelayMs);
         RunLogSequence();
     }
 }
@@ -88,6 +102,10 @@ void TelemetryTask::HandleCommand(Command& cm)
  */
 void TelemetryTask::RunLogSequence()
 {
+    // Send the values the sensors published for the previous sequence as one frame
+    if (TelemetryAggregator::IsEnabled())
+        TelemetryAggregator::SendFrame();
+
     // Flight State
     FlightTask::Inst().SendCommand(Command(REQUEST_COMMAND, (uint16_t)FT_REQUEST_TRANSMIT_STATE));
 
@@ -103,6 +121,12 @@ void TelemetryTask::RunLogSequence()
 	    RequestLogToFlash();
 	    numNonFlashLogs_ = 0;
 	}
+
+	// Queue health, slow changing so only sent every few sequences
+	if(QueueHealthTelemetry::IsEnabled() && ++numLogsSinceQueueHealth_ >= TELEMETRY_QUEUE_HEALTH_LOG_PERIODS) {
+	    QueueHealthTelemetry::SendFrame();
+	    numLogsSinceQueueHealth_ = 0;
+	}
 }
 
 /**
@@ -111,16 +135,14 @@ void TelemetryTask::RunLogSequence()
 void TelemetryTask::RequestSample()
 {
     // Battery
-    BatteryTask::Inst().SendCommand(Command(REQUEST_COMMAND, BATTERY_REQUEST_NEW_SAMPLE));
+    SendRequest(BatteryTask::Inst(), BATTERY_REQUEST_NEW_SAMPLE);
 
-    // Barometer
-    BarometerTask::Inst().SendCommand(Command(REQUEST_COMMAND, (uint16_t)BARO_REQUEST_NEW_SAMPLE));
+    // Barometer samples continuously on its own conversion timer
 
-    // IMU
-    IMUTask::Inst().SendCommand(Command(REQUEST_COMMAND, (uint16_t)IMU_REQUEST_NEW_SAMPLE));
+    // IMU samples continuously on its own sample timer
 
     // Pressure Transducer
-    PressureTransducerTask::Inst().SendCommand(Command(REQUEST_COMMAND, PT_REQUEST_NEW_SAMPLE));
+    SendRequest(PressureTransducerTask::Inst(), PT_REQUEST_NEW_SAMPLE);
 }
 
 /**
@@ -129,19 +151,19 @@ void TelemetryTask::RequestSample()
 void TelemetryTask::RequestTransmit()
 {
     // Battery
-    BatteryTask::Inst().SendCommand(Command(REQUEST_COMMAND, BATTERY_REQUEST_TRANSMIT));
+    SendRequest(BatteryTask::Inst(), BATTERY_REQUEST_TRANSMIT);
 
     // Barometer
-    BarometerTask::Inst().SendCommand(Command(REQUEST_COMMAND, (uint16_t)BARO_REQUEST_TRANSMIT));
+    SendRequest(BarometerTask::Inst(), BARO_REQUEST_TRANSMIT);
 
     // IMU
-    IMUTask::Inst().SendCommand(Command(REQUEST_COMMAND, (uint16_t)IMU_REQUEST_TRANSMIT));
+    SendRequest(IMUTask::Inst(), IMU_REQUEST_TRANSMIT);
 
     // Pressure Transducer
-    PressureTransducerTask::Inst().SendCommand(Command(REQUEST_COMMAND, PT_REQUEST_TRANSMIT));
+    SendRequest(PressureTransducerTask::Inst(), PT_REQUEST_TRANSMIT);
 
     // GPS
-    GPSTask::Inst().SendCommand(Command(REQUEST_COMMAND, (uint16_t)GPS_REQUEST_TRANSMIT));
+    SendRequest(GPSTask::Inst(), GPS_REQUEST_TRANSMIT);
 }
 
 /**
@@ -150,13 +172,25 @@ void TelemetryTask::RequestTransmit()
 void TelemetryTask::RequestLogToFlash()
 {
 	// Barometer
-    BarometerTask::Inst().SendCommand(Command(REQUEST_COMMAND, (uint16_t)BARO_REQUEST_FLASH_LOG));
+    SendRequest(BarometerTask::Inst(), BARO_REQUEST_FLASH_LOG);
 
     // IMU
-    IMUTask::Inst().SendCommand(Command(REQUEST_COMMAND, (uint16_t)IMU_REQUEST_FLASH_LOG));
+    SendRequest(IMUTask::Inst(), IMU_REQUEST_FLASH_LOG);
 
     // GPS
-    GPSTask::Inst().SendCommand(Command(REQUEST_COMMAND, (uint16_t)GPS_REQUEST_FLASH_LOG));
+    SendRequest(GPSTask::Inst(), GPS_REQUEST_FLASH_LOG);
+}
+
+/**
+ * @brief Sends a request to a sensor task without waiting, if the sensor is backlogged the request is
+ *        dropped and the next log period asks again
+ * @param sensor Task to send the request to
+ * @param request Sensor specific request
+ */
+void TelemetryTask::SendRequest(Task& sensor, uint16_t request)
+{
+    Command cm(REQUEST_COMMAND, request);
+    sensor.GetEventQueue()->SendWithPolicy(cm, QUEUE_SEND_DROP_NEWEST);
 }
 
 /**
@@ -164,6 +198,11 @@ void TelemetryTask::RequestLogToFlash()
  */
 void TelemetryTask::SendVentDrainStatus()
 {
+    if (TelemetryAggregator::IsEnabled()) {
+        TelemetryAggregator::UpdateCombustionControl(GPIO::Vent::IsOpen(), GPIO::Drain::IsOpen(), GPIO::MEV_EN::IsOn());
+        return;
+    }
+
     Proto::TelemetryMessage teleMsg;
     teleMsg.set_source(Proto::Node::NODE_DMB);
     teleMsg.set_target(Proto::Node::NODE_RCU);
@@ -177,5 +216,5 @@ void TelemetryTask::SendVentDrainStatus()
     teleMsg.serialize(writeBuffer);
 
     // Send the control message
-    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY);
+    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY, RADIO_MSG_CLASS_STATE);
 }
@@ -10,7 +10,11 @@
 #include "TimerTransitions.hpp"
 #include "FlightTask.hpp"
 
-TimerTransitions::TimerTransitions() {
+TimerTransitions::TimerTransitions() :
+    burnCountdown(LaunchToBurnCallback),
+    coastCountdown(BurnToCoastCallback),
+    descentCountdown(CoastToDescentCallback),
+    recoveryCountdown(DescentToRecoveryCallback) {
 //    ignitionConformation = nullptr;
 }
 
@@ -18,14 +22,10 @@ void TimerTransitions::Setup() {
 	// Ignition timer unused
 	//ignitionCountdown = new Timer(IngnitionToLaunchCallback);
 	//ignitionCountdown->ChangePeriodMs(IGINITION_TIMER_PERIOD_MS);
-	burnCountdown = new Timer(LaunchToBurnCallback);
-	burnCountdown->ChangePeriodMs(BURN_TIMER_PERIOD_MS);
-	coastCountdown = new Timer(BurnToCoastCallback);
-	coastCountdown->ChangePeriodMs(COAST_TIMER_PERIOD_MS);
-	descentCountdown = new Timer(CoastToDescentCallback);
-	descentCountdown->ChangePeriodMs(DESCENT_TIMER_PERIOD_MS);
-	recoveryCountdown = new Timer(DescentToRecoveryCallback);
-	recoveryCountdown->ChangePeriodMs(RECOVERY_TIMER_PERIOD_MS);
+	burnCountdown.ChangePeriodMs(BURN_TIMER_PERIOD_MS);
+	coastCountdown.ChangePeriodMs(COAST_TIMER_PERIOD_MS);
+	descentCountdown.ChangePeriodMs(DESCENT_TIMER_PERIOD_MS);
+	recoveryCountdown.ChangePeriodMs(RECOVERY_TIMER_PERIOD_MS);
 }
 
 // Ignition sequence unused
@@ -36,26 +36,26 @@ void TimerTransitions::Setup() {
 //}
 
 void TimerTransitions::BurnSequence() {
-	if (!burnCountdown->Start())
-		burnCountdown->ResetTimerAndStart();
+	if (!burnCountdown.Start())
+		burnCountdown.ResetTimerAndStart();
     return;
 }
 
 void TimerTransitions::CoastSequence() {
-	if(!coastCountdown->Start())
-		coastCountdown->ResetTimerAndStart();
+	if(!coastCountdown.Start())
+		coastCountdown.ResetTimerAndStart();
     return;
 }
 
 void TimerTransitions::DescentSequence() {
-	if(!descentCountdown->Start())
-		descentCountdown->ResetTimerAndStart();
+	if(!descentCountdown.Start())
+		descentCountdown.ResetTimerAndStart();
     return;
 }
 
 void TimerTransitions::RecoverySequence() {
-	if(!recoveryCountdown->Start())
-		recoveryCountdown->ResetTimerAndStart();
+	if(!recoveryCountdown.Start())
+		recoveryCountdown.ResetTimerAndStart();
     return;
 }
 
@@ -10,13 +10,16 @@
 #include "WatchdogTask.hpp"
 #include "FlightTask.hpp"
 
+/* Static Variable Init ------------------------------------------------------------------*/
+WatchdogTask WatchdogTask::inst_;
+
 /* Macros/Enums ------------------------------------------------------------*/
 constexpr uint32_t HEARTBEAT_TIMER_PERIOD_MS = 20 * 60 * 1000;
 
 /**
  * @brief Constructor for WatchdogTask
  */
-WatchdogTask::WatchdogTask() : Task(WATCHDOG_TASK_QUEUE_DEPTH_OBJS)
+WatchdogTask::WatchdogTask() : Task(&evtQueue_), heartbeatTimer(HeartbeatFailureCallback)
 {
 }
 
@@ -28,15 +31,16 @@ void WatchdogTask::InitTask()
     // Make sure the task is not already initialized
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize watchdog task twice");
 
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)WatchdogTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)WatchdogTask::RunTask,
             (const char*)"WatchdogTask",
-            (uint16_t)WATCHDOG_TASK_STACK_DEPTH_WORDS,
+            (uint32_t)WATCHDOG_TASK_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)WATCHDOG_TASK_RTOS_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
-    SOAR_ASSERT(rtValue == pdPASS, "WatchdogTask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "WatchdogTask::InitTask() - xTaskCreateStatic() failed");
 }
 
 /**
@@ -46,7 +50,7 @@ void WatchdogTask::InitTask()
 void WatchdogTask::HeartbeatFailureCallback(TimerHandle_t rtTimerHandle)
 {
     Timer::DefaultCallback(rtTimerHandle);
-    FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, RSC_ANY_TO_ABORT));
+    FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, RSC_ANY_TO_ABORT));
 }
 
 /**
@@ -64,7 +68,7 @@ void WatchdogTask::HandleCommand(Command& cm)
     }
     case RADIOHB_CHANGE_PERIOD:
         SOAR_PRINT("HB Period Changed to %d s\n", (cm.GetTaskCommand()));
-        heartbeatTimer->ChangePeriodMsAndStart((cm.GetTaskCommand()*1000));
+        heartbeatTimer.ChangePeriodMsAndStart((cm.GetTaskCommand()*1000));
         break;
     default:
         SOAR_PRINT("WatchdogTask - Received Unsupported Command {%d}\n", cm.GetCommand());
@@ -81,11 +85,11 @@ void WatchdogTask::HandleHeartbeat(uint16_t taskCommand)
     case RADIOHB_REQUEST:
         GPIO::LED2::Toggle();
         SOAR_PRINT("HEARTBEAT RECEIVED \n");
-        heartbeatTimer->ResetTimerAndStart();
+        heartbeatTimer.ResetTimerAndStart();
         break;
     case RADIOHB_DISABLED:
         SOAR_PRINT("HEARTBEAT DISABLED \n");
-        heartbeatTimer->Stop();
+        heartbeatTimer.Stop();
         break;
     default:
         SOAR_PRINT("WatchdogTask - Received Unsupported REQUEST_COMMAND {%d}\n", taskCommand);
@@ -102,9 +106,8 @@ void WatchdogTask::Run(void * pvParams)
     uint32_t tempSecondCounter = 0; // TODO: Temporary counter, would normally be in HeartBeat task or HID Task, unless FlightTask is the HeartBeat task
     GPIO::LED1::Off();
 
-    heartbeatTimer = new Timer(HeartbeatFailureCallback);
-    heartbeatTimer->ChangePeriodMs(HEARTBEAT_TIMER_PERIOD_MS);
-    heartbeatTimer->Start();
+    heartbeatTimer.ChangePeriodMs(HEARTBEAT_TIMER_PERIOD_MS);
+    heartbeatTimer.Start();
 
     while (1) {
         GPIO::LED3::On();
@@ -20,6 +20,8 @@
 #include "DebugTask.hpp"
 #include "Task.hpp"
 #include "DMBProtocolTask.hpp"
+#include "TelemetryAggregator.hpp"
+#include "DeltaTelemetry.hpp"
 #include "TelemetryMessage.hpp"
 #include "FlashTask.hpp"
 #include <string.h>
@@ -36,20 +38,19 @@ constexpr int CMD_SIZE = 1;
 constexpr int CMD_TIMEOUT = 150;
 
 // Barometer Commands (should not be modified, non-const due to HAL and C++ strictness)
-static uint8_t ADC_D1_512_CONV_CMD = 0x42;
-static uint8_t ADC_D2_512_CONV_CMD = 0x52;
+constexpr uint8_t ADC_D1_CONV_BASE_CMD = 0x40;    // D1 (pressure) conversion with OSR 256, + 2 per OSR step
+constexpr uint8_t ADC_D2_CONV_BASE_CMD = 0x50;    // D2 (temperature) conversion with OSR 256, + 2 per OSR step
 static uint8_t ADC_READ_CMD = 0x00;
-static uint8_t PROM_READ_SENS_CMD = 0xA2;
-static uint8_t PROM_READ_OFF_CMD = 0xA4;
-static uint8_t PROM_READ_TCS_CMD = 0xA6;
-static uint8_t PROM_READ_TCO_CMD = 0xA8;
-static uint8_t PROM_READ_TREF_CMD = 0xAA;
-static uint8_t PROM_READ_TEMPSENS_CMD = 0xAC;
+constexpr uint8_t PROM_READ_BASE_CMD = 0xA0;    // PROM word n is read with 0xA0 + 2n
 static uint8_t READ_BYTE_CMD = 0x00;
 static uint8_t RESET_CMD = 0x1E;
 
 
+// Max conversion time for each BARO_OSR from the data sheet
+static const uint16_t CONVERSION_TIME_US[] = { 600, 1170, 2280, 4540, 9040 };
+
 /* Variables -----------------------------------------------------------------*/
+BarometerTask BarometerTask::inst_;
 
 /* Prototypes ----------------------------------------------------------------*/
 
@@ -57,9 +58,19 @@ static uint8_t RESET_CMD = 0x1E;
 /**
  * @brief Default constructor, sets and sets up storage for member variables
  */
-BarometerTask::BarometerTask() : Task(TASK_BAROMETER_QUEUE_DEPTH_OBJS)
+BarometerTask::BarometerTask() : Task(&evtQueue_), conversionTimer(ConversionTimerCallback)
 {
-    data = (BarometerData*)soar_malloc(sizeof(BarometerData));
+    promValid = false;
+    promFailures = 0;
+    promRetryPeriod = 1;
+    promRetryCountdown = 0;
+    osr = BARO_DEFAULT_OSR;
+    conversionInFlight = BARO_CONVERSION_NONE;
+    conversionStartTick = 0;
+    lastTemperatureReading = 0;
+    hasTemperatureReading = false;
+    pressureReadingsSinceTemperature = 0;
+    qEvtQueue->EnableCoalescing();
 }
 
 /**
@@ -71,16 +82,17 @@ void BarometerTask::InitTask()
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize Baro task twice");
 
     // Start the task
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)BarometerTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)BarometerTask::RunTask,
             (const char*)"BaroTask",
-            (uint16_t)TASK_BAROMETER_STACK_DEPTH_WORDS,
+            (uint32_t)TASK_BAROMETER_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)TASK_BAROMETER_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
     //Ensure creation succeded
-    SOAR_ASSERT(rtValue == pdPASS, "BarometerTask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "BarometerTask::InitTask() - xTaskCreateStatic() failed");
 }
 
 /**
@@ -89,15 +101,15 @@ void BarometerTask::InitTask()
  */
 void BarometerTask::Run(void * pvParams)
 {
-    while (1) {
-        Command cm;
-
-        //Wait forever for a command
-        qEvtQueue->ReceiveWait(cm);
-        
-        //Process the command
-        HandleCommand(cm);
-    }
+    //Reset the barometer and cache its calibration
+    SetupBarometer();
+
+    //Start the conversion pipeline, the first tick starts the first temperature conversion
+    conversionTimer.SetAutoReload(true);
+    conversionTimer.ChangePeriodMsAndStart(BARO_CONVERSION_PERIOD_MS);
+
+    //Handle commands in batches, duplicate requests in a backlog are coalesced by the queue
+    RunBatchedEventLoop();
 }
 
 /**
@@ -106,15 +118,20 @@ void BarometerTask::Run(void * pvParams)
  */
 void BarometerTask::HandleCommand(Command& cm)
 {
-    //TODO: Since this task will stall for a few milliseconds, we may need a way to eat the whole queue (combine similar eg. REQUEST commands and eat to WDG command etc)
-    //TODO: Maybe a HandleEvtQueue instead that takes in the whole queue and eats the whole thing in order of non-blocking to blocking
-
     //Switch for the GLOBAL_COMMAND
     switch (cm.GetCommand()) {
     case REQUEST_COMMAND: {
         HandleRequestCommand(cm.GetTaskCommand());
+        break;
     }
     case TASK_SPECIFIC_COMMAND: {
+        if (cm.GetTaskCommand() == BARO_CONVERSION_TICK) {
+            HandleConversionTick();
+        }
+        else if (cm.GetTaskCommand() >= BARO_SET_OSR_256 && cm.GetTaskCommand() <= BARO_SET_OSR_4096) {
+            osr = (BARO_OSR)(cm.GetTaskCommand() - BARO_SET_OSR_256);
+            SOAR_PRINT("Barometer OSR set to %d\n", 256 << osr);
+        }
         break;
     }
     default:
@@ -135,10 +152,15 @@ void BarometerTask::HandleRequestCommand(uint16_t taskCommand)
     //Switch for task specific command within DATA_COMMAND
     switch (taskCommand) {
     case BARO_REQUEST_NEW_SAMPLE:
-        SampleBarometer();
+        // Samples are produced continuously by the conversion pipeline
         break;
     case BARO_REQUEST_TRANSMIT:
-        TransmitProtocolBaroData();
+        if (TelemetryAggregator::IsEnabled())
+            TelemetryAggregator::UpdateBaro(data);
+        else if (DeltaTelemetry::IsEnabled())
+            DeltaTelemetry::SendBaro(data);
+        else
+            TransmitProtocolBaroData();
         LogDataToFlash();
         break;
     case BARO_REQUEST_FLASH_LOG:
@@ -146,9 +168,9 @@ void BarometerTask::HandleRequestCommand(uint16_t taskCommand)
 		break;
     case BARO_REQUEST_DEBUG:
         SOAR_PRINT("\t-- Barometer Data --\n");
-        SOAR_PRINT(" Temp (C)       : %d.%d\n", data->temperature_ / 100, data->temperature_ % 100);
-        SOAR_PRINT(" Pressure (mbar): %d.%d\n", data->pressure_ / 100, data->pressure_ % 100);
-        SOAR_PRINT(" Pressure (kPa) : %d.%d\n\n", data->pressure_ / 1000, data->pressure_ % 1000);
+        SOAR_PRINT(" Temp (C)       : %d.%d\n", data.temperature_ / 100, data.temperature_ % 100);
+        SOAR_PRINT(" Pressure (mbar): %d.%d\n", data.pressure_ / 100, data.pressure_ % 100);
+        SOAR_PRINT(" Pressure (kPa) : %d.%d\n\n", data.pressure_ / 1000, data.pressure_ % 1000);
         break;
     default:
         SOAR_PRINT("UARTTask - Received Unsupported REQUEST_COMMAND {%d}\n", taskCommand);
@@ -167,15 +189,15 @@ void BarometerTask::TransmitProtocolBaroData()
     msg.set_source(Proto::Node::NODE_DMB);
     msg.set_target(Proto::Node::NODE_RCU);
     Proto::Baro baroData;
-	baroData.set_baro_pressure(data->pressure_);
-    baroData.set_baro_temperature(data->temperature_);
+	baroData.set_baro_pressure(data.pressure_);
+    baroData.set_baro_temperature(data.temperature_);
 	msg.set_baro(baroData);
 
     EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE> writeBuffer;
     msg.serialize(writeBuffer);
 
     // Send the barometer data
-    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY);
+    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY, RADIO_MSG_CLASS_SENSOR_HIGH_RATE);
 }
 
 /**
@@ -184,75 +206,88 @@ void BarometerTask::TransmitProtocolBaroData()
 void BarometerTask::LogDataToFlash()
 {
     Command flashCommand(DATA_COMMAND, WRITE_DATA_TO_FLASH);
-    flashCommand.CopyDataToCommand((uint8_t*)data, sizeof(BarometerData));
-    FlashTask::Inst().GetEventQueue()->Send(flashCommand);
+    flashCommand.CopyDataToCommand((uint8_t*)&data, sizeof(BarometerData));
+    FlashTask::Inst().GetEventQueue()->SendWithPolicy(flashCommand, QUEUE_SEND_DROP_NEWEST);
 }
 
 /**
- * @brief This function reads and updates pressure and temperature readings
- *          from the barometer.
+ * @brief Conversion timer callback, runs in the timer task so only queues the tick for the barometer task
  */
-void BarometerTask::SampleBarometer()
+void BarometerTask::ConversionTimerCallback(TimerHandle_t rtTimerHandle)
 {
+    Timer::DefaultCallback(rtTimerHandle);
+    Inst().SendCommand(Command(TASK_SPECIFIC_COMMAND, (uint16_t)BARO_CONVERSION_TICK));
+}
+
 /**
- * Variable Descriptions from MS5607-02BA03 Data Sheet:
- *
- * C1 (SENSt1)      - Pressure sensitivity
- * C2 (OFFt1)       - Pressure offset
- * C3 (TCS)         - Temperature coefficient of pressure sensitivity
- * C4 (TCO)         - Temperature coefficient of pressure offset
- * C5 (Tref)        - Reference temperature
- * C6 (TEMPSENS)    - Temperature coefficient of the temperature
- *
- * D1   - Digital pressure value
- * D2   - Digital temperature value
- *
- * dT   - Difference between actual and reference temperature
- *          dT = D2 - Tref = D2 - (C5 * 2^8)
- * TEMP - Actual temperature (-40...85�C with 0.01�C resolution)
- *          TEMP = 20�C + (dT * TEMPSENS) = 2000 + (dT * C6)/2^23
- * OFF  - Offset at actual temperature
- *          OFF = OFFt1 + (TCO * dT) = (C2 * 2^17) + (C4 * dT)/2^6
- * SENS - Sensitivity at actual temperature
- *          SENS = SENSt1 + (TCS * dT) = (C1 * 2^16) + (C3 * dT)/2^7
- * P    - Temperature compensated pressure (10...1200mbar with 0.01mbar resolution)
- *          P = (D1 * SENS) - OFF = ((D1 * SENS)/2^21 - OFF)/2^15
+ * @brief Reads the conversion started on the previous tick and starts the next one, so the task never waits on
+ *        a conversion. A temperature conversion is done first and then after every BARO_PRESSURE_READINGS_PER_TEMPERATURE
+ *        pressure conversions, each pressure reading is compensated with the latest temperature reading.
  */
+void BarometerTask::HandleConversionTick()
+{
+    // Retry the calibration if it could not be read at startup, never compute with unchecked coefficients.
+    // Retries back off so a bad PROM does not reset the barometer every tick
+    if (!promValid) {
+        if (promRetryCountdown > 0) {
+            promRetryCountdown--;
+            return;
+        }
+        if (!SetupBarometer())
+            return;
+    }
 
-    // Variables
-    uint32_t pressureReading = 0;    // Stores a 24 bit value
-    uint32_t temperatureReading = 0;    // Stores a 24 bit value
-    uint8_t dataInBuffer;
-
-    // Reset the barometer
-    HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_RESET);
-    HAL_SPI_Transmit(SystemHandles::SPI_Barometer, &RESET_CMD, CMD_SIZE, CMD_TIMEOUT);
-    osDelay(4); // 2.8ms reload after Reset command
-    HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_SET);
-
-    // Read PROM for calibration coefficients
-    uint16_t c1Sens = ReadCalibrationCoefficients(PROM_READ_SENS_CMD);
-    uint16_t c2Off = ReadCalibrationCoefficients(PROM_READ_OFF_CMD);
-    uint16_t c3Tcs = ReadCalibrationCoefficients(PROM_READ_TCS_CMD);
-    uint16_t c4Tco = ReadCalibrationCoefficients(PROM_READ_TCO_CMD);
-    uint16_t c5Tref = ReadCalibrationCoefficients(PROM_READ_TREF_CMD);
-    uint16_t c6Tempsens = ReadCalibrationCoefficients(PROM_READ_TEMPSENS_CMD);
+    if (conversionInFlight != BARO_CONVERSION_NONE) {
+        // A late tick can leave less than a full period for the conversion, reading early would abort it
+        uint32_t elapsedMs = TICKS_TO_MS(xTaskGetTickCount() - conversionStartTick);
+        if (elapsedMs * 1000 < CONVERSION_TIME_US[osr])
+            return;
+
+        uint32_t reading = ReadConversionResult();
+
+        // The ADC reads 0 if the conversion did not complete
+        if (reading != 0) {
+            if (conversionInFlight == BARO_CONVERSION_TEMPERATURE) {
+                lastTemperatureReading = reading;
+                hasTemperatureReading = true;
+                pressureReadingsSinceTemperature = 0;
+            }
+            else if (hasTemperatureReading) {
+                CompensateSample(reading, lastTemperatureReading, TICKS_TO_MS(conversionStartTick));
+                pressureReadingsSinceTemperature++;
+            }
+        }
+    }
 
-    data->time = TICKS_TO_MS(xTaskGetTickCount()); // ms
+    if (!hasTemperatureReading || pressureReadingsSinceTemperature >= BARO_PRESSURE_READINGS_PER_TEMPERATURE)
+        StartConversion(BARO_CONVERSION_TEMPERATURE);
+    else
+        StartConversion(BARO_CONVERSION_PRESSURE);
+}
 
-    /**
-     * Repeatedly read digital pressure and temperature.
-     * Convert these values into their calibrated counterparts.
-     * Finally, update the data globally if the mutex is available.
-     */
-    /* Read Digital Pressure (D1) ----------------------------------------*/
+/**
+ * @brief Starts a pressure or temperature conversion at the current OSR
+ */
+void BarometerTask::StartConversion(BARO_CONVERSION conversion)
+{
+    uint8_t cmd = ((conversion == BARO_CONVERSION_PRESSURE) ? ADC_D1_CONV_BASE_CMD : ADC_D2_CONV_BASE_CMD) + 2 * osr;
 
-    // Tell the barometer to convert the pressure to a digital value with an over-sampling ratio of 512
     HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_RESET);
-    HAL_SPI_Transmit(SystemHandles::SPI_Barometer, &ADC_D1_512_CONV_CMD, CMD_SIZE, CMD_TIMEOUT);
+    HAL_SPI_Transmit(SystemHandles::SPI_Barometer, &cmd, CMD_SIZE, CMD_TIMEOUT);
     HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_SET);
 
-    osDelay(2); // 1.17ms max conversion time for an over-sampling ratio of 512
+    conversionInFlight = conversion;
+    conversionStartTick = xTaskGetTickCount();
+}
+
+/**
+ * @brief Reads the result of the finished conversion
+ * @return The 24 bit reading, 0 if the conversion was not complete
+ */
+uint32_t BarometerTask::ReadConversionResult()
+{
+    uint8_t dataInBuffer;
+    uint32_t reading = 0;    // Stores a 24 bit value
 
     HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_RESET);
 
@@ -260,44 +295,61 @@ void BarometerTask::SampleBarometer()
 
     // Read the first byte (bits 23-16)
     HAL_SPI_TransmitReceive(SystemHandles::SPI_Barometer, &READ_BYTE_CMD, &dataInBuffer, CMD_SIZE, CMD_TIMEOUT);
-    pressureReading = dataInBuffer << 16;
+    reading = dataInBuffer << 16;
 
     // Read the second byte (bits 15-8)
     HAL_SPI_TransmitReceive(SystemHandles::SPI_Barometer, &READ_BYTE_CMD, &dataInBuffer, CMD_SIZE, CMD_TIMEOUT);
-    pressureReading += dataInBuffer << 8;
+    reading += dataInBuffer << 8;
 
     // Read the third byte (bits 7-0)
     HAL_SPI_TransmitReceive(SystemHandles::SPI_Barometer, &READ_BYTE_CMD, &dataInBuffer, CMD_SIZE, CMD_TIMEOUT);
-    pressureReading += dataInBuffer;
+    reading += dataInBuffer;
 
     HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_SET);
 
-    /* Read Digital Temperature (D2) -------------------------------------*/
-
-    // Tell the barometer to convert the temperature to a digital value with an over-sampling ratio of 512
-    HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_RESET);
-    HAL_SPI_Transmit(SystemHandles::SPI_Barometer, &ADC_D2_512_CONV_CMD, CMD_SIZE, CMD_TIMEOUT);
-    HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_SET);
-
-    osDelay(2); // 1.17ms max conversion time for an over-sampling ratio of 512
-
-    HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_RESET);
-
-    HAL_SPI_Transmit(SystemHandles::SPI_Barometer, &ADC_READ_CMD, CMD_SIZE, CMD_TIMEOUT);
-
-    // Read the first byte (bits 23-16)
-    HAL_SPI_TransmitReceive(SystemHandles::SPI_Barometer, &ADC_READ_CMD, &dataInBuffer, CMD_SIZE, CMD_TIMEOUT);
-    temperatureReading = dataInBuffer << 16;
-
-    // Read the second byte (bits 15-8)
-    HAL_SPI_TransmitReceive(SystemHandles::SPI_Barometer, &ADC_READ_CMD, &dataInBuffer, CMD_SIZE, CMD_TIMEOUT);
-    temperatureReading += dataInBuffer << 8;
+    conversionInFlight = BARO_CONVERSION_NONE;
+    return reading;
+}
 
-    // Read the third byte (bits 7-0)
-    HAL_SPI_TransmitReceive(SystemHandles::SPI_Barometer, &ADC_READ_CMD, &dataInBuffer, CMD_SIZE, CMD_TIMEOUT);
-    temperatureReading += dataInBuffer;
+/**
+ * @brief Calculates the compensated pressure and temperature and publishes them as the current sample
+ * @param pressureReading Raw D1 reading
+ * @param temperatureReading Raw D2 reading
+ * @param sampleTimeMs Time the pressure conversion was started
+ */
+void BarometerTask::CompensateSample(uint32_t pressureReading, uint32_t temperatureReading, uint32_t sampleTimeMs)
+{
+/**
+ * Variable Descriptions from MS5607-02BA03 Data Sheet:
+ *
+ * C1 (SENSt1)      - Pressure sensitivity
+ * C2 (OFFt1)       - Pressure offset
+ * C3 (TCS)         - Temperature coefficient of pressure sensitivity
+ * C4 (TCO)         - Temperature coefficient of pressure offset
+ * C5 (Tref)        - Reference temperature
+ * C6 (TEMPSENS)    - Temperature coefficient of the temperature
+ *
+ * D1   - Digital pressure value
+ * D2   - Digital temperature value
+ *
+ * dT   - Difference between actual and reference temperature
+ *          dT = D2 - Tref = D2 - (C5 * 2^8)
+ * TEMP - Actual temperature (-40...85�C with 0.01�C resolution)
+ *          TEMP = 20�C + (dT * TEMPSENS) = 2000 + (dT * C6)/2^23
+ * OFF  - Offset at actual temperature
+ *          OFF = OFFt1 + (TCO * dT) = (C2 * 2^17) + (C4 * dT)/2^6
+ * SENS - Sensitivity at actual temperature
+ *          SENS = SENSt1 + (TCS * dT) = (C1 * 2^16) + (C3 * dT)/2^7
+ * P    - Temperature compensated pressure (10...1200mbar with 0.01mbar resolution)
+ *          P = (D1 * SENS) - OFF = ((D1 * SENS)/2^21 - OFF)/2^15
+ */
 
-    HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_SET);
+    const uint16_t c1Sens = prom[1];
+    const uint16_t c2Off = prom[2];
+    const uint16_t c3Tcs = prom[3];
+    const uint16_t c4Tco = prom[4];
+    const uint16_t c5Tref = prom[5];
+    const uint16_t c6Tempsens = prom[6];
 
     /* Calculate First-Order Temperature and Parameters ------------------*/
 
@@ -329,8 +381,9 @@ void BarometerTask::SampleBarometer()
     int32_t p = (((pressureReading * sens) >> 21) - off) >> 15;   // Divide this value by 100 to get millibars
 
     /* Store Data --------------------------------------------------------*/
-    data->pressure_ = p;
-    data->temperature_ = temp;
+    data.pressure_ = p;
+    data.temperature_ = temp;
+    data.time = sampleTimeMs;
 
     // All equations provided by MS5607-02BA03 data sheet
 
@@ -339,6 +392,64 @@ void BarometerTask::SampleBarometer()
     // E.x. The value 1234 should be interpreted as 12.34
 }
 
+/**
+ * @brief Resets the barometer and reads its PROM calibration once, so samples only need the two conversions
+ * @return true if the PROM passed its CRC check and the coefficients were cached
+ */
+bool BarometerTask::SetupBarometer()
+{
+    // Reset the barometer, this reloads the PROM into its internal registers
+    HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_RESET);
+    HAL_SPI_Transmit(SystemHandles::SPI_Barometer, &RESET_CMD, CMD_SIZE, CMD_TIMEOUT);
+    osDelay(4); // 2.8ms reload after Reset command
+    HAL_GPIO_WritePin(BARO_CS_GPIO_Port, BARO_CS_Pin, GPIO_PIN_SET);
+
+    // Read the whole PROM, word 0 is factory data and word 7 holds the CRC
+    for (uint8_t i = 0; i < BARO_PROM_NUM_WORDS; i++)
+        prom[i] = ReadCalibrationCoefficients(PROM_READ_BASE_CMD + 2 * i);
+
+    // The reset aborts any conversion in progress
+    conversionInFlight = BARO_CONVERSION_NONE;
+
+    promValid = ((prom[7] & 0x000F) == CalculatePromCrc4(prom));
+    if (!promValid) {
+        if (promFailures == 0)
+            SOAR_PRINT("Non-Fatal-Warning: Barometer PROM CRC failed, retrying with backoff\n");
+        if (promFailures < UINT16_MAX)
+            promFailures++;
+
+        promRetryCountdown = promRetryPeriod;
+        promRetryPeriod = (promRetryPeriod < BARO_PROM_RETRY_MAX_TICKS / 2) ? promRetryPeriod * 2 : BARO_PROM_RETRY_MAX_TICKS;
+    }
+    else if (promFailures > 0) {
+        SOAR_PRINT("Barometer PROM CRC passed after %d failed reads\n", promFailures);
+    }
+
+    return promValid;
+}
+
+/**
+ * @brief Calculates the 4 bit CRC of the PROM contents (MS5607 application note AN520)
+ * @param promWords The 8 PROM words, the CRC bits in the last word are excluded from the calculation
+ * @return The calculated CRC, to compare with the low 4 bits of PROM word 7
+ */
+uint8_t BarometerTask::CalculatePromCrc4(const uint16_t promWords[BARO_PROM_NUM_WORDS])
+{
+    uint16_t remainder = 0;
+
+    for (uint8_t i = 0; i < BARO_PROM_NUM_WORDS * 2; i++) {
+        uint16_t word = promWords[i >> 1];
+        if (i == BARO_PROM_NUM_WORDS * 2 - 1)
+            word &= 0xFF00;    // The CRC itself is not part of the calculation
+
+        remainder ^= (i % 2 == 1) ? (word & 0x00FF) : (word >> 8);
+        for (uint8_t bit = 0; bit < 8; bit++)
+            remainder = (remainder & 0x8000) ? (uint16_t)((remainder << 1) ^ 0x3000) : (uint16_t)(remainder << 1);
+    }
+
+    return (uint8_t)((remainder >> 12) & 0x000F);
+}
+
 /**
  * @brief   This function reads and returns a 16-bit coefficient from the barometer.
  * @param   PROM_READ_CMD   The command to send in order to read the desired
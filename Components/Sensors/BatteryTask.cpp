@@ -12,18 +12,19 @@
 #include "Task.hpp"
 #include <time.h>
 #include "DMBProtocolTask.hpp"
+#include "TelemetryAggregator.hpp"
 #include "GPIO.hpp"
+#include "SensorScale.hpp"
 #include "TelemetryMessage.hpp"
 
 /* Macros --------------------------------------------------------------------*/
-constexpr double ADC_CONVERSION_FACTOR = 3.3/4095;
-constexpr int VOLTAGE_DIVIDER_SCALE = 4; // Value to scale voltage back to original value
 constexpr int BATTERY_VOLTAGE_ADC_POLL_TIMEOUT = 50;
 /* Structs -------------------------------------------------------------------*/
 
 /* Constants -----------------------------------------------------------------*/
 
 /* Variables -----------------------------------------------------------------*/
+BatteryTask BatteryTask::inst_;
 
 /* Prototypes ----------------------------------------------------------------*/
 
@@ -31,9 +32,9 @@ constexpr int BATTERY_VOLTAGE_ADC_POLL_TIMEOUT = 50;
 /**
  * @brief Default constructor, sets and sets up storage for member variables
  */
-BatteryTask::BatteryTask() : Task(BATTERY_TASK_QUEUE_DEPTH_OBJS)
+BatteryTask::BatteryTask() : Task(&evtQueue_)
 {
-    data = (BatteryData*)soar_malloc(sizeof(BatteryData));
+    qEvtQueue->EnableCoalescing();
 }
 
 /**
@@ -45,16 +46,17 @@ void BatteryTask::InitTask()
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize battery task twice");
 
     // Start the task
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)BatteryTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)BatteryTask::RunTask,
             (const char*)"BatTask",
-            (uint16_t)BATTERY_TASK_STACK_DEPTH_WORDS,
+            (uint32_t)BATTERY_TASK_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)BATTERY_TASK_RTOS_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
     //Ensure creation succeded
-    SOAR_ASSERT(rtValue == pdPASS, "BatteryTask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "BatteryTask::InitTask() - xTaskCreateStatic() failed");
 }
 
 /**
@@ -63,15 +65,8 @@ void BatteryTask::InitTask()
  */
 void BatteryTask::Run(void * pvParams)
 {
-    while (1) {
-        Command cm;
-
-        //Wait forever for a command
-        qEvtQueue->ReceiveWait(cm);
-
-        //Process the command
-        HandleCommand(cm);
-    }
+    //Handle commands in batches, duplicate requests in a backlog are coalesced by the queue
+    RunBatchedEventLoop();
 }
 
 /**
@@ -84,6 +79,7 @@ void BatteryTask::HandleCommand(Command& cm)
     switch (cm.GetCommand()) {
     case REQUEST_COMMAND: {
         HandleRequestCommand(cm.GetTaskCommand());
+        break;
     }
     case TASK_SPECIFIC_COMMAND: {
         break;
@@ -109,10 +105,13 @@ void BatteryTask::HandleRequestCommand(uint16_t taskCommand)
         SampleBatteryVoltage();
         break;
     case BATTERY_REQUEST_TRANSMIT:
-    	TransmitProtocolBatteryData();
+    	if (TelemetryAggregator::IsEnabled())
+    	    TelemetryAggregator::UpdateBattery(data, GPIO::PowerSelect::IsInternal());
+    	else
+    	    TransmitProtocolBatteryData();
         break;
     case BATTERY_REQUEST_DEBUG:
-        SOAR_PRINT("|VOLTAGE_TASK| Battery Voltage (V): %d.%d, MCU Timestamp: %u\r\n", data->voltage_ / 1000, data->voltage_ % 1000,
+        SOAR_PRINT("|VOLTAGE_TASK| Battery Voltage (V): %d.%d, MCU Timestamp: %u\r\n", data.voltage_ / 1000, data.voltage_ % 1000,
         timestampPT);
         SOAR_PRINT("Power State: %d, \r\n", GetPowerState());
         break;
@@ -128,9 +127,7 @@ void BatteryTask::HandleRequestCommand(uint16_t taskCommand)
  */
 void BatteryTask::SampleBatteryVoltage()
 {
-	double adcVal[1] = {};
-	double batteryVoltageValue = 0;
-	double vi = 0;
+	uint32_t adcVal[1] = {};
 
 	HAL_ADC_Start(&hadc2);  // Enables ADC and starts conversion of regular channels
 	if(HAL_ADC_PollForConversion(&hadc2, BATTERY_VOLTAGE_ADC_POLL_TIMEOUT) == HAL_OK) { //Check if conversion is completed
@@ -138,9 +135,7 @@ void BatteryTask::SampleBatteryVoltage()
 		HAL_ADC_Stop(&hadc2);
 		}
 
-	vi = (ADC_CONVERSION_FACTOR * (adcVal[0])); // Converts 12 bit ADC value into voltage
-	batteryVoltageValue = (vi * VOLTAGE_DIVIDER_SCALE) * 1000; // Multiply by 1000 to keep decimal places
-	data->voltage_ = (uint32_t) batteryVoltageValue; // Battery Voltage in volts
+	data.voltage_ = BatteryVoltageScale::Apply(adcVal[0]); // Battery Voltage in mV
 
 	timestampPT = HAL_GetTick();
 }
@@ -165,7 +160,7 @@ void BatteryTask::TransmitProtocolBatteryData()
 	msg.set_source(Proto::Node::NODE_DMB);
 	msg.set_target(Proto::Node::NODE_RCU);
 	Proto::Battery bat;
-	bat.set_voltage(data->voltage_);
+	bat.set_voltage(data.voltage_);
 	bat.set_power_source(GetPowerState());
 	msg.set_battery(bat);
 
@@ -173,5 +168,5 @@ void BatteryTask::TransmitProtocolBatteryData()
 	msg.serialize(writeBuffer);
 
     // Send the battery voltage data
-    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY);
+    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY, RADIO_MSG_CLASS_SENSOR_LOW_RATE);
 }
@@ -12,17 +12,20 @@
 */
 #include "GPSTask.hpp"
 #include "SystemDefines.hpp"
-#include <stdlib.h>
 #include <cstring>
 #include "DMBProtocolTask.hpp"
+#include "TelemetryAggregator.hpp"
 #include "FlashTask.hpp"
 
+/* Static Variable Init ------------------------------------------------------------------*/
+GPSTask GPSTask::inst_;
+
 /**
  * @brief Default constructor, sets up storage for member variables
  */
-GPSTask::GPSTask() : Task(TASK_GPS_QUEUE_DEPTH_OBJS)
+GPSTask::GPSTask() : Task(&evtQueue_)
 {
-    data = (GpsData*)soar_malloc(sizeof(GpsData));
+    qEvtQueue->EnableCoalescing();
 }
 
 /**
@@ -33,15 +36,16 @@ void GPSTask::InitTask()
     // Make sure the task is not already initialized
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize GPS task twice");
     
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)GPSTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)GPSTask::RunTask,
             (const char*)"GPSTask",
-            (uint16_t)TASK_GPS_STACK_DEPTH_WORDS,
+            (uint32_t)TASK_GPS_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)TASK_GPS_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
     
-    SOAR_ASSERT(rtValue == pdPASS, "GPSTask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "GPSTask::InitTask() - xTaskCreateStatic() failed");
 }
 
 /**
@@ -67,7 +71,7 @@ void GPSTask::HandleGPSRxComplete()
 
                 if (gpsDataMutex.LockFromISR())
                 {
-                    memcpy(&data->buffer_, &rx_buffer, rx_index); // Copy to gps data buffer from rx_buffer
+                    memcpy(&data.buffer_, &rx_buffer, rx_index); // Copy to gps data buffer from rx_buffer
 
                     // Notify the gps task that we have data available
                     Command cm(DATA_COMMAND, EVENT_GPS_RX_PARSE_READY);
@@ -127,16 +131,8 @@ void GPSTask::Run(void * pvParams)
     //Setup the GPS
 	ReceiveData();
 
-    //Task run loop
-    while(1) {
-        Command cm;
-
-        //Wait forever for a command
-        qEvtQueue->ReceiveWait(cm);
-
-        //Process the command
-        HandleCommand(cm);
-    }
+    //Handle commands in batches, duplicate requests in a backlog are coalesced by the queue
+    RunBatchedEventLoop();
 }
 
 /**
@@ -178,19 +174,22 @@ void GPSTask::HandleRequestCommand(uint16_t taskCommand)
         SOAR_PRINT("GPSTask - Received Sample Request (unsupported)\n");
         break;
     case GPS_REQUEST_TRANSMIT:
-        TransmitProtocolData();
+        if (TelemetryAggregator::IsEnabled())
+            TelemetryAggregator::UpdateGPS(data);
+        else
+            TransmitProtocolData();
         break;
     case GPS_REQUEST_FLASH_LOG:
         LogDataToFlash();
         break;
     case GPS_REQUEST_DEBUG:
         SOAR_PRINT("\t-- GPS Data --\n");
-        SOAR_PRINT(" Time : %d\n", data->time_);
-        SOAR_PRINT(" Latitude  (deg, min) : (%d, %d)\n", data->latitude_.degrees_, data->latitude_.minutes_);
-        SOAR_PRINT(" Longitude (deg, min) : (%d, %d)\n", data->longitude_.degrees_, data->longitude_.minutes_);
-        SOAR_PRINT(" Altitude   (N, unit) : (%d, %c)\n", data->antennaAltitude_.altitude_, data->antennaAltitude_.unit_);
-        SOAR_PRINT(" Altitude   (N, unit) : (%d, %c)\n", data->geoidAltitude_.altitude_, data->geoidAltitude_.unit_);
-        SOAR_PRINT(" Altitude   (N, unit) : (%d, %c)\n", data->totalAltitude_.altitude_, data->totalAltitude_.unit_);
+        SOAR_PRINT(" Time : %d\n", data.time_);
+        SOAR_PRINT(" Latitude  (deg, min) : (%d, %d)\n", data.latitude_.degrees_, data.latitude_.minutes_);
+        SOAR_PRINT(" Longitude (deg, min) : (%d, %d)\n", data.longitude_.degrees_, data.longitude_.minutes_);
+        SOAR_PRINT(" Altitude   (N, unit) : (%d, %c)\n", data.antennaAltitude_.altitude_, data.antennaAltitude_.unit_);
+        SOAR_PRINT(" Altitude   (N, unit) : (%d, %c)\n", data.geoidAltitude_.altitude_, data.geoidAltitude_.unit_);
+        SOAR_PRINT(" Altitude   (N, unit) : (%d, %c)\n", data.totalAltitude_.altitude_, data.totalAltitude_.unit_);
         break;
     default:
         SOAR_PRINT("GPSTask - Received Unsupported REQUEST_COMMAND {%d}\n", taskCommand);
@@ -216,24 +215,24 @@ void GPSTask::TransmitProtocolData()
 {
 
     Proto::CoordinateType lat;
-    lat.set_degrees(data->latitude_.degrees_);
-    lat.set_minutes(data->latitude_.minutes_);
+    lat.set_degrees(data.latitude_.degrees_);
+    lat.set_minutes(data.latitude_.minutes_);
 
     Proto::CoordinateType lon;
-    lon.set_degrees(data->longitude_.degrees_);
-    lon.set_minutes(data->longitude_.minutes_);
+    lon.set_degrees(data.longitude_.degrees_);
+    lon.set_minutes(data.longitude_.minutes_);
 
     Proto::AltitudeType antAltitude;
-    antAltitude.set_altitude(data->antennaAltitude_.altitude_);
-    antAltitude.set_unit(data->antennaAltitude_.unit_);
+    antAltitude.set_altitude(data.antennaAltitude_.altitude_);
+    antAltitude.set_unit(data.antennaAltitude_.unit_);
 
     Proto::AltitudeType geoIdAltitude;
-    geoIdAltitude.set_altitude(data->geoidAltitude_.altitude_);
-    geoIdAltitude.set_unit(data->geoidAltitude_.unit_);
+    geoIdAltitude.set_altitude(data.geoidAltitude_.altitude_);
+    geoIdAltitude.set_unit(data.geoidAltitude_.unit_);
 
     Proto::AltitudeType totalAltitude;
-    totalAltitude.set_altitude(data->totalAltitude_.altitude_);
-    totalAltitude.set_unit(data->totalAltitude_.unit_);
+    totalAltitude.set_altitude(data.totalAltitude_.altitude_);
+    totalAltitude.set_unit(data.totalAltitude_.unit_);
 
     Proto::TelemetryMessage msg;
     msg.set_source(Proto::Node::NODE_DMB);
@@ -244,14 +243,14 @@ void GPSTask::TransmitProtocolData()
     coord.set_antenna_altitude(antAltitude);
     coord.set_geo_id_altitude(geoIdAltitude);
     coord.set_total_altitude(totalAltitude);
-    coord.set_time(data->time_);
+    coord.set_time(data.time_);
     msg.set_gps(coord);
 
     EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE> writeBuffer;
     msg.serialize(writeBuffer);
 
     // Send the barometer data
-    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY);
+    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY, RADIO_MSG_CLASS_SENSOR_LOW_RATE);
 }
 
 /**
@@ -261,16 +260,16 @@ void GPSTask::TransmitProtocolData()
 void GPSTask::LogDataToFlash()
 {
     GPSDataFlashLog flashLogData;
-    flashLogData.time_ = data->time_;
-    flashLogData.latitude_ = data->latitude_;
-    flashLogData.longitude_ = data->longitude_;
-    flashLogData.antennaAltitude_ = data->antennaAltitude_;
-    flashLogData.geoidAltitude_ = data->geoidAltitude_;
-    flashLogData.totalAltitude_ = data->totalAltitude_;
+    flashLogData.time_ = data.time_;
+    flashLogData.latitude_ = data.latitude_;
+    flashLogData.longitude_ = data.longitude_;
+    flashLogData.antennaAltitude_ = data.antennaAltitude_;
+    flashLogData.geoidAltitude_ = data.geoidAltitude_;
+    flashLogData.totalAltitude_ = data.totalAltitude_;
 
     Command flashCommand(DATA_COMMAND, WRITE_DATA_TO_FLASH);
     flashCommand.CopyDataToCommand((uint8_t*)&flashLogData, sizeof(GPSDataFlashLog));
-    FlashTask::Inst().GetEventQueue()->Send(flashCommand);
+    FlashTask::Inst().GetEventQueue()->SendWithPolicy(flashCommand, QUEUE_SEND_DROP_NEWEST);
 }
 
 /**
@@ -287,7 +286,7 @@ void GPSTask::ParseGpsData()
     }
 
     // Vars
-    char* gps_item = &data->buffer_[0];
+    char* gps_item = &data.buffer_[0];
     uint8_t item_len = 0;
     uint8_t counter = 0;
     uint8_t done = 0;
@@ -314,15 +313,15 @@ void GPSTask::ParseGpsData()
                 // case 0 is when gps_item is "$GPGGA"
             case 1:
             {
-                data->time_ = (uint32_t)(atof(gps_item) * 100); // HHMMSS.SS format. Time is multiplied by 100.
+                data.time_ = (uint32_t)Utils::stringToFixed(gps_item, 2); // HHMMSS.SS format. Time is multiplied by 100.
                 break;
             }
 
             case 2:
             {
-                double latitude = (atof(gps_item)); // DDMM.MMMMMM
-                data->latitude_.degrees_ = (int32_t)latitude / 100; // First 2 numbers are the latitude degrees
-                data->latitude_.minutes_ = (int32_t)((latitude - data->latitude_.degrees_ * 100) * 100000); // Latitude minutes is multplied by 100000
+                int32_t latitude = Utils::stringToFixed(gps_item, 5); // DDMM.MMMMMM, multiplied by 100000
+                data.latitude_.degrees_ = latitude / 10000000; // First 2 numbers are the latitude degrees
+                data.latitude_.minutes_ = latitude % 10000000; // Latitude minutes is multplied by 100000
                 break;
             }
 
@@ -334,8 +333,8 @@ void GPSTask::ParseGpsData()
                 // S is represented as a negative value
                 if (direction == 'S')
                 {
-                    data->latitude_.degrees_ *= -1;
-                    data->latitude_.minutes_ *= -1;
+                    data.latitude_.degrees_ *= -1;
+                    data.latitude_.minutes_ *= -1;
                 }
 
                 break;
@@ -343,9 +342,9 @@ void GPSTask::ParseGpsData()
 
             case 4:
             {
-                double longitude = (atof(gps_item)); // DDMM.MMMMMM
-                data->longitude_.degrees_ = (int32_t)longitude / 100; // First 2 numbers are the longitude degrees
-                data->longitude_.minutes_ = (int32_t)((longitude - data->longitude_.degrees_ * 100) * 100000); // Longitude minutes is multplied by 100000
+                int32_t longitude = Utils::stringToFixed(gps_item, 5); // DDDMM.MMMMM, multiplied by 100000
+                data.longitude_.degrees_ = longitude / 10000000; // First 3 numbers are the longitude degrees
+                data.longitude_.minutes_ = longitude % 10000000; // Longitude minutes is multplied by 100000
                 break;
             }
 
@@ -357,8 +356,8 @@ void GPSTask::ParseGpsData()
                 // W is represented as a negative value
                 if (direction == 'W')
                 {
-                    data->longitude_.degrees_ *= -1;
-                    data->longitude_.minutes_ *= -1;
+                    data.longitude_.degrees_ *= -1;
+                    data.longitude_.minutes_ *= -1;
                 }
 
                 break;
@@ -366,25 +365,25 @@ void GPSTask::ParseGpsData()
 
             case 9:
             {
-                data->antennaAltitude_.altitude_ = (int32_t)(atof(gps_item) * 10); // Antenna altitude is multiplied by 10
+                data.antennaAltitude_.altitude_ = Utils::stringToFixed(gps_item, 1); // Antenna altitude is multiplied by 10
                 break;
             }
 
             case 10: // Antenna altitude unit
             {
-                data->antennaAltitude_.unit_ = *gps_item;
+                data.antennaAltitude_.unit_ = *gps_item;
                 break;
             }
 
             case 11:
             {
-                data->geoidAltitude_.altitude_ = (int32_t)(atof(gps_item) * 10); // Geoid altitude is multiplied by 10
+                data.geoidAltitude_.altitude_ = Utils::stringToFixed(gps_item, 1); // Geoid altitude is multiplied by 10
                 break;
             }
 
             case 12: // Geoid altitude unit
             {
-                data->geoidAltitude_.unit_ = *gps_item;
+                data.geoidAltitude_.unit_ = *gps_item;
                 break;
             }
 
@@ -398,8 +397,8 @@ void GPSTask::ParseGpsData()
     } while (done == 0);
 
     // Subtract geoid altitude from antenna altitude to get Height Above Ellipsoid (HAE)
-    data->totalAltitude_.altitude_ = data->antennaAltitude_.altitude_ - data->geoidAltitude_.altitude_;
-    data->totalAltitude_.unit_ = data->antennaAltitude_.unit_;
+    data.totalAltitude_.altitude_ = data.antennaAltitude_.altitude_ - data.geoidAltitude_.altitude_;
+    data.totalAltitude_.unit_ = data.antennaAltitude_.unit_;
 
     memset(gpsTaskRxBuffer, 0, GPS_TASK_RX_BUFFER_SIZE);
     gpsDataMutex.Unlock();
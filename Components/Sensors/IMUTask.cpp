@@ -19,7 +19,12 @@
 #include "DebugTask.hpp"
 #include "Task.hpp"
 #include "DMBProtocolTask.hpp"
+#include "TelemetryAggregator.hpp"
+#include "DeltaTelemetry.hpp"
 #include "FlashTask.hpp"
+#include "SensorScale.hpp"
+#include "stm32f4xx_ll_dma.h"
+#include "stm32f4xx_ll_bus.h"
 #include <string.h>
 
 
@@ -40,6 +45,9 @@ constexpr int CMD_TIMEOUT = 150;
 #define G1_CTRL_REGISTER_ADDR 0x10 // CTRL_REG1_G (10h)
 #define XL6_CTRL_REGISTER_ADDR 0x20 // CTRL_REG6_XL (20h)
 #define M3_CTRL_REGISTER_ADDR 0x22 // CTRL_REG3_M (22h)
+#define CTRL_REG9_REGISTER_ADDR 0x23 // CTRL_REG9 (23h)
+#define FIFO_CTRL_REGISTER_ADDR 0x2E // FIFO_CTRL (2Eh)
+#define FIFO_SRC_REGISTER_ADDR 0x2F // FIFO_SRC (2Fh)
 #define WHOAMI_REGISTER_ADDR 0x0F  // WHO_AM_I_A/G (Accel/Gyro - expected value is 104)
 #define WHOAMIM_REGISTER_ADDR 0x0F // WHO_AM_I_M (Magnetometer - expected value is 61)
 
@@ -47,10 +55,6 @@ constexpr int CMD_TIMEOUT = 150;
 #define ACCEL_X_LOW_REGISTER_ADDR 0x28
 #define MAGNETO_X_LOW_REGISTER_ADDR 0x28
 
-#define ACCEL_SENSITIVITY 0.732 // Unit is mg/LSB
-#define GYRO_SENSITIVITY 8.75  // Unit is mdps/LSB
-#define MAGENTO_SENSITIVITY 0.14 // Unit is mgauss/LSB
-
 // Full Commands
 static uint8_t ACTIVATE_GYRO_ACCEL_CMD = G1_CTRL_REGISTER_ADDR | WRITE_CMD_MASK;
 // 011 00 0 00 -> ODR 119, 245 DPS
@@ -65,12 +69,36 @@ static uint8_t ACTIVATE_MAGNETO_CMD = M3_CTRL_REGISTER_ADDR | WRITE_CMD_MASK;
 static uint8_t ACTIVATE_MAGNETO_DATA = 0x80;
 
 static uint8_t READ_GYRO_X_G_LOW_CMD = GYRO_X_G_LOW_REGISTER_ADDR | READ_CMD_MASK | ACCEL_GYRO_MASK;
-static uint8_t READ_ACCEL_X_LOW_CMD = ACCEL_X_LOW_REGISTER_ADDR | READ_CMD_MASK | ACCEL_GYRO_MASK;
 static uint8_t READ_MAGNETO_X_LOW_CMD = MAGNETO_X_LOW_REGISTER_ADDR | READ_CMD_MASK | MAGNETO_MASK;
 static uint8_t READ_WHOAMI_CMD = WHOAMI_REGISTER_ADDR | READ_CMD_MASK | ACCEL_GYRO_MASK;
 static uint8_t READ_WHOAMIM_CMD = WHOAMIM_REGISTER_ADDR | READ_CMD_MASK | MAGNETO_MASK;
 
+// Low bits of CTRL_REG1_G and CTRL_REG6_XL kept when the ODR is changed
+#define GYRO_CTRL_FS_BW 0x00    // 245 DPS, default bandwidth
+#define ACCEL_CTRL_FS_BW 0x08   // +/- 16G, bandwidth from ODR
+
+#define CTRL_REG9_FIFO_EN 0x02
+#define FIFO_CTRL_MODE_BYPASS 0x00  // FMODE 000, FIFO off and emptied
+#define FIFO_CTRL_MODE_STREAM 0xC0  // FMODE 110, oldest sample is overwritten when full
+#define FIFO_SRC_OVRN 0x40          // FIFO was full and a sample was overwritten
+#define FIFO_SRC_FSS_MASK 0x3F      // Number of unread samples
+
+// Offsets of the output registers within a burst read starting at OUT_X_G
+constexpr uint8_t BURST_GYRO_OFFSET = 0;
+constexpr uint8_t BURST_ACCEL_OFFSET = ACCEL_X_LOW_REGISTER_ADDR - GYRO_X_G_LOW_REGISTER_ADDR;
+static_assert(BURST_ACCEL_OFFSET + 6 == IMU_BURST_LEN_BYTES, "Burst read must end at OUT_Z_XL");
+
+// Output data rate in Hz, indexed by IMU_ODR - IMU_ODR_119
+static const uint16_t ODR_HZ[] = { 119, 238, 476, 952 };
+
+// SPI1 DMA streams (RM0090 DMA2 request mapping, channel 3)
+#define IMU_SPI_DMA DMA2
+#define IMU_SPI_DMA_CHANNEL LL_DMA_CHANNEL_3
+#define IMU_SPI_RX_DMA_STREAM LL_DMA_STREAM_0
+#define IMU_SPI_TX_DMA_STREAM LL_DMA_STREAM_3
+
 /* Variables -----------------------------------------------------------------*/
+IMUTask IMUTask::inst_;
 
 /* Prototypes ----------------------------------------------------------------*/
 
@@ -78,9 +106,23 @@ static uint8_t READ_WHOAMIM_CMD = WHOAMIM_REGISTER_ADDR | READ_CMD_MASK | MAGNET
 /**
  * @brief Default constructor, sets and sets up storage for member variables
  */
-IMUTask::IMUTask() : Task(TASK_IMU_QUEUE_DEPTH_OBJS)
+IMUTask::IMUTask() : Task(&evtQueue_), pollTimer(PollTimerCallback)
 {
-    data = (AccelGyroMagnetismData*)soar_malloc(sizeof(AccelGyroMagnetismData));
+    qEvtQueue->EnableCoalescing();
+    odr = IMU_DEFAULT_ODR;
+    pendingOdr = IMU_DEFAULT_ODR;
+    drainInFlight = false;
+    dmaActive = false;
+    drainSlots = 0;
+    drainNextSlot = 0;
+    drainPollTick = 0;
+    drainAfterGap = true;
+    fifoOverruns = 0;
+    pollsSinceMagRead = 0;
+    memset(&batch, 0, sizeof(batch));
+
+    memset(burstTxBuf, 0, sizeof(burstTxBuf));
+    burstTxBuf[0] = GYRO_X_G_LOW_REGISTER_ADDR | READ_CMD_MASK | ACCEL_GYRO_MASK;
 }
 
 /**
@@ -92,16 +134,17 @@ void IMUTask::InitTask()
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize IMU task twice");
 
     // Start the task
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)IMUTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)IMUTask::RunTask,
             (const char*)"IMUTask",
-            (uint16_t)TASK_IMU_STACK_DEPTH_WORDS,
+            (uint32_t)TASK_IMU_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)TASK_IMU_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
     //Ensure creation succeded
-    SOAR_ASSERT(rtValue == pdPASS, "IMUTask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "IMUTask::InitTask() - xTaskCreateStatic() failed");
 }
 
 /**
@@ -115,17 +158,15 @@ void IMUTask::Run(void* pvParams)
 
     //Setup the IMU
     SetupIMU();
+    SetupFifo();
+    SetupBurstDMA();
 
-    //Task run loop
-    while (1) {
-        Command cm;
-        
-        //Wait forever for a command
-        qEvtQueue->ReceiveWait(cm);
+    //Drain the IMU FIFO continuously, it holds every sample taken since the last poll
+    pollTimer.SetAutoReload(true);
+    pollTimer.ChangePeriodMsAndStart(IMU_FIFO_POLL_PERIOD_MS);
 
-        //Process the command
-        HandleCommand(cm);
-    }
+    //Handle commands in batches, duplicate requests in a backlog are coalesced by the queue
+    RunBatchedEventLoop();
 }
 
 /**
@@ -134,9 +175,6 @@ void IMUTask::Run(void* pvParams)
  */
 void IMUTask::HandleCommand(Command& cm)
 {
-    //TODO: Since this task will stall for a few milliseconds, we may need a way to eat the whole queue (combine similar eg. REQUEST commands and eat to WDG command etc)
-    //TODO: Maybe a HandleEvtQueue instead that takes in the whole queue and eats the whole thing in order of non-blocking to blocking
-
     //Switch for the GLOBAL_COMMAND
     switch (cm.GetCommand()) {
     case REQUEST_COMMAND: {
@@ -144,6 +182,13 @@ void IMUTask::HandleCommand(Command& cm)
         break;
     }
     case TASK_SPECIFIC_COMMAND: {
+        uint16_t taskCommand = cm.GetTaskCommand();
+        if (taskCommand == IMU_FIFO_POLL_TICK)
+            PollFifo();
+        else if (taskCommand == IMU_FIFO_DRAIN_COMPLETE)
+            ProcessDrain();
+        else if (taskCommand >= IMU_SET_ODR_119 && taskCommand <= IMU_SET_ODR_952)
+            SetOutputDataRate((IMU_ODR)(IMU_ODR_119 + (taskCommand - IMU_SET_ODR_119)));
         break;
     }
     default:
@@ -164,20 +209,25 @@ void IMUTask::HandleRequestCommand(uint16_t taskCommand)
     //Switch for task specific command within DATA_COMMAND
     switch (taskCommand) {
     case IMU_REQUEST_NEW_SAMPLE:
-        SampleIMU();
+        // Samples are drained from the FIFO continuously on the poll timer
         break;
     case IMU_REQUEST_TRANSMIT:
-        TransmitProtocolData();
-        LogDataToFlash();
+        if (TelemetryAggregator::IsEnabled())
+            TelemetryAggregator::UpdateIMU(data);
+        else if (DeltaTelemetry::IsEnabled())
+            DeltaTelemetry::SendIMU(data);
+        else
+            TransmitProtocolData();
         break;
     case IMU_REQUEST_FLASH_LOG:
         LogDataToFlash();
         break;
     case IMU_REQUEST_DEBUG:
         SOAR_PRINT("\t-- IMU Data --\n");
-        SOAR_PRINT(" Accel (x,y,z) : (%d, %d, %d) milli-Gs\n", data->accelX_, data->accelY_, data->accelZ_);
-        SOAR_PRINT(" Gyro (x,y,z)  : (%d, %d, %d) milli-deg/s\n", data->gyroX_, data->gyroY_, data->gyroZ_);
-        SOAR_PRINT(" Mag (x,y,z)   : (%d, %d, %d) milli-gauss\n", data->magnetoX_, data->magnetoY_, data->magnetoZ_);
+        SOAR_PRINT(" Accel (x,y,z) : (%d, %d, %d) milli-Gs\n", data.accelX_, data.accelY_, data.accelZ_);
+        SOAR_PRINT(" Gyro (x,y,z)  : (%d, %d, %d) milli-deg/s\n", data.gyroX_, data.gyroY_, data.gyroZ_);
+        SOAR_PRINT(" Mag (x,y,z)   : (%d, %d, %d) milli-gauss\n", data.magnetoX_, data.magnetoY_, data.magnetoZ_);
+        SOAR_PRINT(" ODR %d Hz, FIFO overruns %d\n", ODR_HZ[odr - IMU_ODR_119], fifoOverruns);
         break;
     default:
         SOAR_PRINT("IMUTask - Received Unsupported REQUEST_COMMAND {%d}\n", taskCommand);
@@ -197,22 +247,22 @@ void IMUTask::TransmitProtocolData()
     msg.set_source(Proto::Node::NODE_DMB);
     msg.set_target(Proto::Node::NODE_RCU);
     Proto::Imu imuData;
-    imuData.set_accel_x(data->accelX_);
-    imuData.set_accel_y(data->accelY_);
-    imuData.set_accel_z(data->accelZ_);
-    imuData.set_gyro_x(data->gyroX_);
-    imuData.set_gyro_y(data->gyroY_);
-    imuData.set_gyro_z(data->gyroZ_);
-    imuData.set_mag_x(data->magnetoX_);
-    imuData.set_mag_y(data->magnetoY_);
-    imuData.set_mag_z(data->magnetoZ_);
+    imuData.set_accel_x(data.accelX_);
+    imuData.set_accel_y(data.accelY_);
+    imuData.set_accel_z(data.accelZ_);
+    imuData.set_gyro_x(data.gyroX_);
+    imuData.set_gyro_y(data.gyroY_);
+    imuData.set_gyro_z(data.gyroZ_);
+    imuData.set_mag_x(data.magnetoX_);
+    imuData.set_mag_y(data.magnetoY_);
+    imuData.set_mag_z(data.magnetoZ_);
     msg.set_imu(imuData);
 
     EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE> writeBuffer;
     msg.serialize(writeBuffer);
 
     // Send the barometer data
-    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY);
+    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY, RADIO_MSG_CLASS_SENSOR_HIGH_RATE);
 }
 
 /**
@@ -221,58 +271,350 @@ void IMUTask::TransmitProtocolData()
 void IMUTask::LogDataToFlash()
 {
     Command flashCommand(DATA_COMMAND, WRITE_DATA_TO_FLASH);
-    flashCommand.CopyDataToCommand((uint8_t*)data, sizeof(AccelGyroMagnetismData));
-    FlashTask::Inst().GetEventQueue()->Send(flashCommand);
+    flashCommand.CopyDataToCommand((uint8_t*)&data, sizeof(AccelGyroMagnetismData));
+    FlashTask::Inst().GetEventQueue()->SendWithPolicy(flashCommand, QUEUE_SEND_DROP_NEWEST);
 }
 
 /**
- * @brief This function reads and updates the IMU data
+ * @brief Poll timer callback, runs in the timer task so only queues the tick for the IMU task
  */
-void IMUTask::SampleIMU()
+void IMUTask::PollTimerCallback(TimerHandle_t rtTimerHandle)
 {
-    //Storable data
-    uint8_t dataBuffer[6];
-    int16_t accelX, accelY, accelZ;
-    int16_t gyroX, gyroY, gyroZ;
-    int16_t magnetoX, magnetoY, magnetoZ;
+    Timer::DefaultCallback(rtTimerHandle);
+    Inst().SendCommand(Command(TASK_SPECIFIC_COMMAND, (uint16_t)IMU_FIFO_POLL_TICK));
+}
 
-    data->time = TICKS_TO_MS(xTaskGetTickCount()); // ms
+/**
+ * @brief Reads the FIFO level and starts draining every unread slot over DMA, the interrupt queues
+ *        IMU_FIFO_DRAIN_COMPLETE once all of them were read. The magnetometer is read between drains
+ *        at its own rate, the SPI bus is only used from this task while no drain is running.
+ */
+void IMUTask::PollFifo()
+{
+    // The previous drain is still running or not processed yet, the samples stay in the FIFO for the next poll
+    if (drainInFlight)
+        return;
 
-    //READ------------------------------------------------------
-    HAL_GPIO_WritePin(IMU_XL_GY_CS_GPIO_Port, IMU_XL_GY_CS_Pin, GPIO_PIN_RESET);
-    HAL_SPI_Transmit(SystemHandles::SPI_IMU, &READ_GYRO_X_G_LOW_CMD, 1, CMD_TIMEOUT);
-    HAL_SPI_Receive(SystemHandles::SPI_IMU, &dataBuffer[0], 6, CMD_TIMEOUT);
-    HAL_GPIO_WritePin(IMU_XL_GY_CS_GPIO_Port, IMU_XL_GY_CS_Pin, GPIO_PIN_SET);
-    gyroX = (dataBuffer[1] << 8) | (dataBuffer[0]);
-    gyroY = (dataBuffer[3] << 8) | (dataBuffer[2]);
-    gyroZ = (dataBuffer[5] << 8) | (dataBuffer[4]);
+    // A change requested while a drain was running, and the drain ended without ProcessDrain (DMA error)
+    if (pendingOdr != odr)
+        ApplyOutputDataRate();
+
+    if (++pollsSinceMagRead >= IMU_MAG_READ_DIVIDER) {
+        pollsSinceMagRead = 0;
+        SampleMagnetometer();
+    }
+
+    uint8_t fifoSrc = ReadRegister(FIFO_SRC_REGISTER_ADDR);
+    drainPollTick = xTaskGetTickCount();
+
+    if (fifoSrc & FIFO_SRC_OVRN) {
+        fifoOverruns++;
+        drainAfterGap = true;
+    }
+
+    uint8_t slots = fifoSrc & FIFO_SRC_FSS_MASK;
+    if (slots == 0)
+        return;
+    if (slots > IMU_FIFO_DEPTH)
+        slots = IMU_FIFO_DEPTH;
+
+    // Clear any overrun left from a blocking transfer before the DMA takes over the bus
+    SPI_TypeDef* spi = SystemHandles::SPI_IMU->Instance;
+    (void)spi->DR;
+    (void)spi->SR;
+
+    drainSlots = slots;
+    drainNextSlot = 0;
+    drainInFlight = true;
+    dmaActive = true;
+    StartSlotRead(0);
+}
+
+/**
+ * @brief Arms both DMA streams and reads one FIFO slot, called from the task for the first slot and
+ *        from the DMA interrupt for the rest so a drain costs one task wake-up
+ * @param slot FIFO slot to read into
+ */
+void IMUTask::StartSlotRead(uint8_t slot)
+{
+    SPI_TypeDef* spi = SystemHandles::SPI_IMU->Instance;
+
+    LL_DMA_ClearFlag_TC0(IMU_SPI_DMA);
+    LL_DMA_ClearFlag_TE0(IMU_SPI_DMA);
+    LL_DMA_ClearFlag_TC3(IMU_SPI_DMA);
+    LL_DMA_ClearFlag_TE3(IMU_SPI_DMA);
+    LL_DMA_SetMemoryAddress(IMU_SPI_DMA, IMU_SPI_RX_DMA_STREAM, (uint32_t)slotRxBuf[slot]);
+    LL_DMA_SetDataLength(IMU_SPI_DMA, IMU_SPI_RX_DMA_STREAM, sizeof(slotRxBuf[slot]));
+    LL_DMA_SetDataLength(IMU_SPI_DMA, IMU_SPI_TX_DMA_STREAM, sizeof(burstTxBuf));
 
     HAL_GPIO_WritePin(IMU_XL_GY_CS_GPIO_Port, IMU_XL_GY_CS_Pin, GPIO_PIN_RESET);
-    HAL_SPI_Transmit(SystemHandles::SPI_IMU, &READ_ACCEL_X_LOW_CMD, 1, CMD_TIMEOUT);
-    HAL_SPI_Receive(SystemHandles::SPI_IMU, &dataBuffer[0], 6, CMD_TIMEOUT);
+
+    // Rx request first so no received byte is missed, then Tx starts clocking
+    spi->CR2 |= SPI_CR2_RXDMAEN;
+    LL_DMA_EnableStream(IMU_SPI_DMA, IMU_SPI_RX_DMA_STREAM);
+    LL_DMA_EnableStream(IMU_SPI_DMA, IMU_SPI_TX_DMA_STREAM);
+    spi->CR2 |= SPI_CR2_TXDMAEN;
+    spi->CR1 |= SPI_CR1_SPE;
+}
+
+/**
+ * @brief Handles the SPI1 Rx DMA interrupt, a slot is complete once its last byte was received.
+ *        Starts the next slot of the drain, or queues IMU_FIFO_DRAIN_COMPLETE after the last one.
+ * @attention MUST be called inside the DMA2_Stream0_IRQHandler
+ */
+void IMUTask::HandleIRQ_SpiRxDMA()
+{
+    bool complete = LL_DMA_IsActiveFlag_TC0(IMU_SPI_DMA);
+    bool error = LL_DMA_IsActiveFlag_TE0(IMU_SPI_DMA);
+    LL_DMA_ClearFlag_TC0(IMU_SPI_DMA);
+    LL_DMA_ClearFlag_TE0(IMU_SPI_DMA);
+
+    if (!complete && !error)
+        return;
+
+    SPI_TypeDef* spi = SystemHandles::SPI_IMU->Instance;
+    spi->CR2 &= ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+    LL_DMA_DisableStream(IMU_SPI_DMA, IMU_SPI_TX_DMA_STREAM);
     HAL_GPIO_WritePin(IMU_XL_GY_CS_GPIO_Port, IMU_XL_GY_CS_Pin, GPIO_PIN_SET);
-    accelX = (dataBuffer[1] << 8) | (dataBuffer[0]);
-    accelY = (dataBuffer[3] << 8) | (dataBuffer[2]);
-    accelZ = (dataBuffer[5] << 8) | (dataBuffer[4]);
+
+    if (error) {
+        // Slots already read are dropped, the unread ones stay in the FIFO for the next poll
+        dmaActive = false;
+        drainAfterGap = true;
+        drainInFlight = false;
+        return;
+    }
+
+    if (++drainNextSlot < drainSlots) {
+        StartSlotRead(drainNextSlot);
+        return;
+    }
+
+    // The slots stay owned by this drain until ProcessDrain clears drainInFlight
+    dmaActive = false;
+    Command cm(TASK_SPECIFIC_COMMAND, (uint16_t)IMU_FIFO_DRAIN_COMPLETE);
+    if (!qEvtQueue->SendPriorityFromISR(cm)) {
+        // Nothing will process this drain, drop it and flag the lost samples
+        drainAfterGap = true;
+        drainInFlight = false;
+    }
+}
+
+/**
+ * @brief Adds every drained sample to the batch record, and updates the current sample
+ *        to the mean of the drain so telemetry sees the whole interval instead of a single sample
+ */
+void IMUTask::ProcessDrain()
+{
+    // Already dropped by a DMA error
+    if (!drainInFlight || dmaActive)
+        return;
+
+    uint8_t slots = drainSlots;
+    uint16_t odrHz = ODR_HZ[odr - IMU_ODR_119];
+    uint32_t pollMs = TICKS_TO_MS(drainPollTick);
+
+    if (drainAfterGap) {
+        LogBatchToFlash();
+        batch.flags |= IMU_BATCH_FLAG_GAP;
+        drainAfterGap = false;
+    }
+
+    int32_t sums[6] = { 0 };
+    for (uint8_t i = 0; i < slots; i++) {
+        const uint8_t* regs = &slotRxBuf[i][1];
+        const uint8_t* gyro = &regs[BURST_GYRO_OFFSET];
+        const uint8_t* accel = &regs[BURST_ACCEL_OFFSET];
+        int16_t raw[6] = {
+            (int16_t)((gyro[1] << 8) | gyro[0]),
+            (int16_t)((gyro[3] << 8) | gyro[2]),
+            (int16_t)((gyro[5] << 8) | gyro[4]),
+            (int16_t)((accel[1] << 8) | accel[0]),
+            (int16_t)((accel[3] << 8) | accel[2]),
+            (int16_t)((accel[5] << 8) | accel[4]),
+        };
+
+        for (uint8_t axis = 0; axis < 6; axis++)
+            sums[axis] += raw[axis];
+
+        // The newest sample was taken when the FIFO level was read, the rest one ODR period apart before it
+        AddToBatch(raw, pollMs - ((uint32_t)(slots - 1 - i) * 1000) / odrHz);
+    }
+
+    data.time = pollMs; // ms
+
+    // Write to storage
+    data.gyroX_ = ImuGyroScale::Apply(sums[0] / slots); // mdps
+    data.gyroY_ = ImuGyroScale::Apply(sums[1] / slots); // mdps
+    data.gyroZ_ = ImuGyroScale::Apply(sums[2] / slots); // mdps
+    data.accelX_ = ImuAccelScale::Apply(sums[3] / slots); // mg
+    data.accelY_ = ImuAccelScale::Apply(sums[4] / slots); // mg
+    data.accelZ_ = ImuAccelScale::Apply(sums[5] / slots); // mg
+
+    // Slots are free for the next drain
+    drainInFlight = false;
+
+    // The drained samples were taken at the old rate, so a requested ODR change is applied after them
+    if (pendingOdr != odr)
+        ApplyOutputDataRate();
+}
+
+/**
+ * @brief Appends one raw sample to the batch record, logs the record when it is full
+ * @param raw Gyro x,y,z then accel x,y,z register values
+ * @param timeMs Time the sample was taken
+ */
+void IMUTask::AddToBatch(const int16_t (&raw)[6], uint32_t timeMs)
+{
+    if (batch.count == 0) {
+        batch.time = timeMs;
+        batch.odrHz = ODR_HZ[odr - IMU_ODR_119];
+    }
+
+    memcpy(batch.samples[batch.count], raw, sizeof(raw));
+    if (++batch.count >= IMU_BATCH_MAX_SAMPLES)
+        LogBatchToFlash();
+}
+
+/**
+ * @brief Logs the batch record if it holds any samples and starts a new one.
+ *        Records are always logged at full size so the flash readback can identify them by length.
+ */
+void IMUTask::LogBatchToFlash()
+{
+    if (batch.count == 0)
+        return;
+
+    if (IMU_FIFO_BATCH_LOGGING_ENABLED) {
+        Command flashCommand(DATA_COMMAND, WRITE_DATA_TO_FLASH);
+        flashCommand.CopyDataToCommand((uint8_t*)&batch, sizeof(IMUBatchData));
+        FlashTask::Inst().GetEventQueue()->SendWithPolicy(flashCommand, QUEUE_SEND_DROP_NEWEST);
+    }
+
+    batch.count = 0;
+    batch.flags = 0;
+}
+
+/**
+ * @brief Reads the magnetometer, it has its own chip select and a much lower ODR than the accel/gyro
+ */
+void IMUTask::SampleMagnetometer()
+{
+    uint8_t dataBuffer[6];
 
     HAL_GPIO_WritePin(IMU_MAG_CS_GPIO_Port, IMU_MAG_CS_Pin, GPIO_PIN_RESET);
     HAL_SPI_Transmit(SystemHandles::SPI_IMU, &READ_MAGNETO_X_LOW_CMD, 1, CMD_TIMEOUT);
     HAL_SPI_Receive(SystemHandles::SPI_IMU, &dataBuffer[0], 6, CMD_TIMEOUT);
     HAL_GPIO_WritePin(IMU_MAG_CS_GPIO_Port, IMU_MAG_CS_Pin, GPIO_PIN_SET);
-    magnetoX = (dataBuffer[1] << 8) | (dataBuffer[0]);
-    magnetoY = (dataBuffer[3] << 8) | (dataBuffer[2]);
-    magnetoZ = (dataBuffer[5] << 8) | (dataBuffer[4]);
+    int16_t magnetoX = (dataBuffer[1] << 8) | (dataBuffer[0]);
+    int16_t magnetoY = (dataBuffer[3] << 8) | (dataBuffer[2]);
+    int16_t magnetoZ = (dataBuffer[5] << 8) | (dataBuffer[4]);
 
-    // Write to storage
-    data->accelX_ = accelX * ACCEL_SENSITIVITY; // mg
-    data->accelY_ = accelY * ACCEL_SENSITIVITY; // mg
-    data->accelZ_ = accelZ * ACCEL_SENSITIVITY; // mg
-    data->gyroX_ = gyroX * GYRO_SENSITIVITY; // mdps
-    data->gyroY_ = gyroY * GYRO_SENSITIVITY; // mdps
-    data->gyroZ_ = gyroZ * GYRO_SENSITIVITY; // mdps
-    data->magnetoX_ = magnetoX * MAGENTO_SENSITIVITY; // mgauss
-    data->magnetoY_ = magnetoY * MAGENTO_SENSITIVITY; // mgauss
-    data->magnetoZ_ = magnetoZ * MAGENTO_SENSITIVITY; // mgauss
+    data.magnetoX_ = ImuMagScale::Apply(magnetoX); // mgauss
+    data.magnetoY_ = ImuMagScale::Apply(magnetoY); // mgauss
+    data.magnetoZ_ = ImuMagScale::Apply(magnetoZ); // mgauss
+}
+
+/**
+ * @brief Configures the SPI1 DMA streams for burst reads, the streams are armed per FIFO slot in StartSlotRead
+ */
+void IMUTask::SetupBurstDMA()
+{
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA2);
+
+    const uint32_t streams[2] = { IMU_SPI_RX_DMA_STREAM, IMU_SPI_TX_DMA_STREAM };
+    for (uint32_t stream : streams) {
+        LL_DMA_DisableStream(IMU_SPI_DMA, stream);
+        while (LL_DMA_IsEnabledStream(IMU_SPI_DMA, stream)) {}
+
+        LL_DMA_SetChannelSelection(IMU_SPI_DMA, stream, IMU_SPI_DMA_CHANNEL);
+        LL_DMA_SetStreamPriorityLevel(IMU_SPI_DMA, stream, LL_DMA_PRIORITY_HIGH);
+        LL_DMA_SetMode(IMU_SPI_DMA, stream, LL_DMA_MODE_NORMAL);
+        LL_DMA_SetPeriphIncMode(IMU_SPI_DMA, stream, LL_DMA_PERIPH_NOINCREMENT);
+        LL_DMA_SetMemoryIncMode(IMU_SPI_DMA, stream, LL_DMA_MEMORY_INCREMENT);
+        LL_DMA_SetPeriphSize(IMU_SPI_DMA, stream, LL_DMA_PDATAALIGN_BYTE);
+        LL_DMA_SetMemorySize(IMU_SPI_DMA, stream, LL_DMA_MDATAALIGN_BYTE);
+        LL_DMA_DisableFifoMode(IMU_SPI_DMA, stream);
+        LL_DMA_SetPeriphAddress(IMU_SPI_DMA, stream, (uint32_t)&SystemHandles::SPI_IMU->Instance->DR);
+    }
+
+    LL_DMA_SetDataTransferDirection(IMU_SPI_DMA, IMU_SPI_RX_DMA_STREAM, LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
+    LL_DMA_SetDataTransferDirection(IMU_SPI_DMA, IMU_SPI_TX_DMA_STREAM, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetMemoryAddress(IMU_SPI_DMA, IMU_SPI_TX_DMA_STREAM, (uint32_t)burstTxBuf);
+
+    // Only the Rx stream interrupts, it finishes after the Tx stream
+    LL_DMA_EnableIT_TC(IMU_SPI_DMA, IMU_SPI_RX_DMA_STREAM);
+    LL_DMA_EnableIT_TE(IMU_SPI_DMA, IMU_SPI_RX_DMA_STREAM);
+
+    // Same priority as the UART DMA interrupts, must be at or below configMAX_SYSCALL_INTERRUPT_PRIORITY to use FromISR calls
+    NVIC_SetPriority(DMA2_Stream0_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 5, 0));
+    NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+}
+
+/**
+ * @brief Enables the accel/gyro FIFO in stream mode, it keeps the newest 32 samples until they are read
+ */
+void IMUTask::SetupFifo()
+{
+    WriteRegister(CTRL_REG9_REGISTER_ADDR, CTRL_REG9_FIFO_EN);
+    WriteRegister(FIFO_CTRL_REGISTER_ADDR, FIFO_CTRL_MODE_STREAM);
+}
+
+/**
+ * @brief Requests an accel/gyro output data rate change. While a FIFO drain is running the DMA owns the bus,
+ *        so the change is applied by ProcessDrain once the drained samples are processed.
+ * @param newOdr Output data rate to change to
+ */
+void IMUTask::SetOutputDataRate(IMU_ODR newOdr)
+{
+    pendingOdr = newOdr;
+    if (!drainInFlight && pendingOdr != odr)
+        ApplyOutputDataRate();
+}
+
+/**
+ * @brief Changes the accel/gyro output data rate to pendingOdr, only called while no drain is running.
+ *        The samples still in the FIFO were taken at the old rate, so the FIFO is emptied and the batch
+ *        record is closed so every record has a single rate.
+ */
+void IMUTask::ApplyOutputDataRate()
+{
+    // Gyro and accel share the gyro ODR while both are active, CTRL_REG6_XL is written to match
+    WriteRegister(G1_CTRL_REGISTER_ADDR, (pendingOdr << 5) | GYRO_CTRL_FS_BW);
+    WriteRegister(XL6_CTRL_REGISTER_ADDR, (pendingOdr << 5) | ACCEL_CTRL_FS_BW);
+    WriteRegister(FIFO_CTRL_REGISTER_ADDR, FIFO_CTRL_MODE_BYPASS);
+    WriteRegister(FIFO_CTRL_REGISTER_ADDR, FIFO_CTRL_MODE_STREAM);
+
+    LogBatchToFlash();
+    odr = pendingOdr;
+    drainAfterGap = true;
+
+    SOAR_PRINT("IMU ODR set to %d Hz\n", ODR_HZ[odr - IMU_ODR_119]);
+}
+
+/**
+ * @brief Writes a single accel/gyro register, blocking
+ */
+void IMUTask::WriteRegister(uint8_t reg, uint8_t value)
+{
+    uint8_t cmd[2] = { (uint8_t)(reg | WRITE_CMD_MASK | ACCEL_GYRO_MASK), value };
+    HAL_GPIO_WritePin(IMU_XL_GY_CS_GPIO_Port, IMU_XL_GY_CS_Pin, GPIO_PIN_RESET);
+    HAL_SPI_Transmit(SystemHandles::SPI_IMU, cmd, 2, CMD_TIMEOUT);
+    HAL_GPIO_WritePin(IMU_XL_GY_CS_GPIO_Port, IMU_XL_GY_CS_Pin, GPIO_PIN_SET);
+}
+
+/**
+ * @brief Reads a single accel/gyro register, blocking
+ */
+uint8_t IMUTask::ReadRegister(uint8_t reg)
+{
+    uint8_t cmd = reg | READ_CMD_MASK | ACCEL_GYRO_MASK;
+    uint8_t value = 0;
+    HAL_GPIO_WritePin(IMU_XL_GY_CS_GPIO_Port, IMU_XL_GY_CS_Pin, GPIO_PIN_RESET);
+    HAL_SPI_Transmit(SystemHandles::SPI_IMU, &cmd, 1, CMD_TIMEOUT);
+    HAL_SPI_Receive(SystemHandles::SPI_IMU, &value, 1, CMD_TIMEOUT);
+    HAL_GPIO_WritePin(IMU_XL_GY_CS_GPIO_Port, IMU_XL_GY_CS_Pin, GPIO_PIN_SET);
+    return value;
 }
 
 /**
@@ -10,24 +10,51 @@
 #include "Task.hpp"
 #include "Data.h"
 #include "SystemDefines.hpp"
+#include "Timer.hpp"
 
 
 /* Macros/Enums ------------------------------------------------------------*/
 enum BARO_TASK_COMMANDS {
     BARO_NONE = 0,
-    BARO_REQUEST_NEW_SAMPLE,// Get a new barometer sample, task will be blocked for polling time
+    BARO_REQUEST_NEW_SAMPLE,// No effect, samples are produced continuously by the conversion pipeline
     BARO_REQUEST_TRANSMIT,    // Send the current barometer data over the Radio and Log to Flash
     BARO_REQUEST_DEBUG,        // Send the current barometer data over the Debug UART
     BARO_REQUEST_FLASH_LOG,   // Log the current barometer data to flash
 };
 
+enum BARO_TASK_SPECIFIC_COMMANDS {
+    BARO_CONVERSION_TICK = 0,   // Sent by the conversion timer, reads the finished conversion and starts the next one
+    BARO_SET_OSR_256,           // Change the over-sampling ratio, takes effect from the next conversion
+    BARO_SET_OSR_512,
+    BARO_SET_OSR_1024,
+    BARO_SET_OSR_2048,
+    BARO_SET_OSR_4096,
+};
+
+// Over-sampling ratio, each step doubles the conversion time and lowers the noise
+enum BARO_OSR : uint8_t {
+    BARO_OSR_256 = 0,
+    BARO_OSR_512,
+    BARO_OSR_1024,
+    BARO_OSR_2048,
+    BARO_OSR_4096,
+};
+
+enum BARO_CONVERSION : uint8_t {
+    BARO_CONVERSION_NONE = 0,
+    BARO_CONVERSION_PRESSURE,       // D1
+    BARO_CONVERSION_TEMPERATURE,    // D2
+};
+
+constexpr BARO_OSR BARO_DEFAULT_OSR = BARO_OSR_512;
+constexpr uint8_t BARO_PROM_NUM_WORDS = 8;    // Factory data, C1-C6 calibration coefficients, CRC
+
 /* Class ------------------------------------------------------------------*/
 class BarometerTask : public Task
 {
 public:
     static BarometerTask& Inst() {
-        static BarometerTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
@@ -44,17 +71,45 @@ protected:
     void TransmitProtocolBaroData();
     void LogDataToFlash();
 
-    // Sampling
-    void SampleBarometer();
+    // Sampling, conversions are pipelined, each timer tick reads the finished conversion and starts the next
+    static void ConversionTimerCallback(TimerHandle_t rtTimerHandle);
+    void HandleConversionTick();
+    void StartConversion(BARO_CONVERSION conversion);
+    uint32_t ReadConversionResult();
+    void CompensateSample(uint32_t pressureReading, uint32_t temperatureReading, uint32_t sampleTimeMs);
     uint16_t ReadCalibrationCoefficients(uint8_t PROM_READ_CMD);
 
+    // Setup Functions
+    bool SetupBarometer();
+    static uint8_t CalculatePromCrc4(const uint16_t promWords[BARO_PROM_NUM_WORDS]);
+
     // Data
-    BarometerData* data;
+    BarometerData data;
+    uint16_t prom[BARO_PROM_NUM_WORDS];    // PROM contents read at startup, prom[1] to prom[6] are the C1-C6 coefficients
+    bool promValid;                        // True once the PROM passed its CRC check
+    uint16_t promFailures;                 // Number of PROM reads that failed the CRC check
+    uint16_t promRetryPeriod;              // Conversion ticks to wait after the next failed PROM read, doubles up to BARO_PROM_RETRY_MAX_TICKS
+    uint16_t promRetryCountdown;           // Conversion ticks left before the PROM is read again
+
+    // Conversion pipeline
+    Timer conversionTimer;
+    BARO_OSR osr;
+    BARO_CONVERSION conversionInFlight;
+    uint32_t conversionStartTick;
+    uint32_t lastTemperatureReading;       // Latest D2, reused for the pressure readings that follow it
+    bool hasTemperatureReading;
+    uint8_t pressureReadingsSinceTemperature;
 
 private:
     BarometerTask();                                        // Private constructor
     BarometerTask(const BarometerTask&);                    // Prevent copy-construction
     BarometerTask& operator=(const BarometerTask&);            // Prevent assignment
+
+    static BarometerTask inst_;    // Singleton instance, defined in the .cpp
+
+    // Static storage
+    StaticQueue<TASK_BAROMETER_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage
+    TaskStorage<TASK_BAROMETER_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_SENSOR_BAROMETER_TASK_HPP_
@@ -27,8 +27,7 @@ class BatteryTask : public Task
 {
 public:
     static BatteryTask& Inst() {
-        static BatteryTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
@@ -47,13 +46,19 @@ protected:
     enum Proto::Battery::PowerSource GetPowerState();
 
     // Data
-    BatteryData* data;
+    BatteryData data;
     uint32_t timestampPT;
 
 private:
     BatteryTask();                                        // Private constructor
     BatteryTask(const BatteryTask&);                    // Prevent copy-construction
     BatteryTask& operator=(const BatteryTask&);            // Prevent assignment
+
+    static BatteryTask inst_;    // Singleton instance, defined in the .cpp
+
+    // Static storage
+    StaticQueue<BATTERY_TASK_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage
+    TaskStorage<BATTERY_TASK_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_SENSOR_BATTERY_TASK_HPP_
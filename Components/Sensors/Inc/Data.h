@@ -28,6 +28,23 @@ typedef struct
     int32_t     time;
 } AccelGyroMagnetismData;
 
+/*
+ * Batch of consecutive accel/gyro samples drained from the IMU FIFO, logged at the full ODR.
+ * Samples are raw register values (gyro x,y,z then accel x,y,z), scale with the IMU sensitivities.
+ * Sample i was taken at time + i * 1000 / odrHz ms.
+ */
+#define IMU_BATCH_MAX_SAMPLES 16
+#define IMU_BATCH_FLAG_GAP 0x01    // Samples were lost (FIFO overrun or ODR change) right before the first sample
+
+typedef struct
+{
+    int32_t     time;       // ms, time of the first sample
+    uint16_t    odrHz;
+    uint8_t     count;      // Number of valid samples
+    uint8_t     flags;
+    int16_t     samples[IMU_BATCH_MAX_SAMPLES][6];
+} IMUBatchData;
+
 typedef struct
 {
     int32_t     pressure_;
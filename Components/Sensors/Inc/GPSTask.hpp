@@ -52,8 +52,7 @@ class GPSTask : public Task
 {
 public:
     static GPSTask& Inst() {
-        static GPSTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
@@ -82,7 +81,7 @@ protected:
     // Member variables
     Mutex gpsDataMutex;
     uint8_t gpsTaskRxBuffer[GPS_TASK_RX_BUFFER_SIZE];
-    GpsData* data;
+    GpsData data;
 
 private:
     // Private Functions
@@ -90,8 +89,14 @@ private:
     GPSTask(const GPSTask&);                        // Prevent copy-construction
     GPSTask& operator=(const GPSTask&);            // Prevent assignment
 
+    static GPSTask inst_;    // Singleton instance, defined in the .cpp
+
     // Private Variables
 
+
+    // Static storage
+    StaticQueue<TASK_GPS_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage
+    TaskStorage<TASK_GPS_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif // SOAR_SENSOR_GPS_TASK_HPP_
@@ -10,28 +10,51 @@
 #include "Task.hpp"
 #include "Data.h"
 #include "SystemDefines.hpp"
+#include "Timer.hpp"
 
 
 /* Macros/Enums ------------------------------------------------------------*/
 enum IMU_TASK_COMMANDS {
     IMU_NONE = 0,
-    IMU_REQUEST_NEW_SAMPLE,// Get a new IMU sample, task will be blocked for polling time
-    IMU_REQUEST_TRANSMIT,    // Send the current IMU data over the Radio and Logs to Flash
+    IMU_REQUEST_NEW_SAMPLE,// No effect, samples are drained from the IMU FIFO continuously
+    IMU_REQUEST_TRANSMIT,    // Send the current IMU data over the Radio
     IMU_REQUEST_DEBUG,        // Send the current IMU data over the Debug UART
     IMU_REQUEST_FLASH_LOG,
 };
 
+enum IMU_TASK_SPECIFIC_COMMANDS {
+    IMU_FIFO_POLL_TICK = 0,     // Sent by the poll timer, starts draining the FIFO
+    IMU_FIFO_DRAIN_COMPLETE,    // Sent by the DMA interrupt when every FIFO slot of a drain was read
+    IMU_SET_ODR_119,            // Change the accel/gyro output data rate, takes effect once the running drain is processed
+    IMU_SET_ODR_238,
+    IMU_SET_ODR_476,
+    IMU_SET_ODR_952,
+};
+
+// Accel/gyro output data rate, value is the CTRL_REG1_G ODR_G field
+enum IMU_ODR : uint8_t {
+    IMU_ODR_119 = 3,
+    IMU_ODR_238,
+    IMU_ODR_476,
+    IMU_ODR_952,
+};
+
+constexpr IMU_ODR IMU_DEFAULT_ODR = IMU_ODR_119;    // Must match ACTIVATE_GYRO_ACCEL_DATA used by SetupIMU
+constexpr uint8_t IMU_FIFO_DEPTH = 32;
+constexpr uint8_t IMU_BURST_LEN_BYTES = 22;    // OUT_X_G (0x18) to OUT_Z_XL (0x2D) in one auto-increment read, one FIFO slot
+
 /* Class ------------------------------------------------------------------*/
 class IMUTask : public Task
 {
 public:
     static IMUTask& Inst() {
-        static IMUTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
 
+    void HandleIRQ_SpiRxDMA();    // Must be called from the SPI1 Rx DMA stream interrupt
+
 protected:
     static void RunTask(void* pvParams) { IMUTask::Inst().Run(pvParams); } // Static Task Interface, passes control to the instance Run();
 
@@ -45,18 +68,56 @@ protected:
     void LogDataToFlash();
 
     // Sampling
-    void SampleIMU();
+    static void PollTimerCallback(TimerHandle_t rtTimerHandle);
+    void PollFifo();
+    void StartSlotRead(uint8_t slot);
+    void ProcessDrain();
+    void SampleMagnetometer();
+
+    // Batch logging
+    void AddToBatch(const int16_t (&raw)[6], uint32_t timeMs);
+    void LogBatchToFlash();
 
     // Setup Functions
     uint8_t SetupIMU();
+    void SetupFifo();
+    void SetupBurstDMA();
+    void SetOutputDataRate(IMU_ODR newOdr);
+    void ApplyOutputDataRate();
+    void WriteRegister(uint8_t reg, uint8_t value);    // Accel/gyro registers only
+    uint8_t ReadRegister(uint8_t reg);
 
     // Data
-    AccelGyroMagnetismData* data;
+    AccelGyroMagnetismData data;
+
+    // FIFO drain, one burst read per FIFO slot chained from the DMA interrupt
+    Timer pollTimer;
+    IMU_ODR odr;
+    IMU_ODR pendingOdr;                             // Requested ODR, differs from odr until the change is applied
+    uint8_t burstTxBuf[IMU_BURST_LEN_BYTES + 1];                    // Read command followed by dummy bytes
+    uint8_t slotRxBuf[IMU_FIFO_DEPTH][IMU_BURST_LEN_BYTES + 1];     // Per slot, byte received during the command followed by the registers
+    volatile bool drainInFlight;                    // Set from the start of a drain until ProcessDrain has read the slots
+    volatile bool dmaActive;                        // Set while the DMA is reading slots of the current drain
+    volatile uint8_t drainSlots;                    // Number of slots in the current drain
+    volatile uint8_t drainNextSlot;                 // Slot being read by the DMA
+    uint32_t drainPollTick;                         // Tick count when the FIFO level was read, time of the newest drained sample
+    volatile bool drainAfterGap;                    // Samples were lost before the current drain
+    uint32_t fifoOverruns;
+    uint8_t pollsSinceMagRead;                      // FIFO polls since the magnetometer was last read
+
+    // Batch record being filled for logging
+    IMUBatchData batch;
 
 private:
     IMUTask();                                        // Private constructor
     IMUTask(const IMUTask&);                    // Prevent copy-construction
     IMUTask& operator=(const IMUTask&);            // Prevent assignment
+
+    static IMUTask inst_;    // Singleton instance, defined in the .cpp
+
+    // Static storage
+    StaticQueue<TASK_IMU_QUEUE_DEPTH_OBJS, TASK_IMU_PRIORITY_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage, the priority lane carries drain complete events and ODR changes
+    TaskStorage<TASK_IMU_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_SENSOR_IMU_TASK_HPP_
@@ -25,8 +25,7 @@ class PressureTransducerTask : public Task
 {
 public:
     static PressureTransducerTask& Inst() {
-        static PressureTransducerTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
@@ -44,13 +43,19 @@ protected:
     void TransmitProtocolPressureData();
 
     // Data
-    PressureTransducerData* data;
+    PressureTransducerData data;
     uint32_t timestampPT;
 
 private:
     PressureTransducerTask();                                        // Private constructor
     PressureTransducerTask(const PressureTransducerTask&);                    // Prevent copy-construction
     PressureTransducerTask& operator=(const PressureTransducerTask&);            // Prevent assignment
+
+    static PressureTransducerTask inst_;    // Singleton instance, defined in the .cpp
+
+    // Static storage
+    StaticQueue<TASK_PRESSURE_TRANSDUCER_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage
+    TaskStorage<TASK_PRESSURE_TRANSDUCER_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_SENSOR_PRESSURE_TRANSDUCER_TASK_HPP_
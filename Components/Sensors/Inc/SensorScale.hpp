@@ -0,0 +1,53 @@
+/**
+ ******************************************************************************
+ * File Name          : SensorScale.hpp
+ * Description        : Compile-time fixed-point scale factors that convert raw sensor
+ *    readings to the fixed point units of Data.h without touching the FPU or soft-float.
+ ******************************************************************************
+*/
+#ifndef SOAR_SENSOR_SCALE_HPP_
+#define SOAR_SENSOR_SCALE_HPP_
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Class -----------------------------------------------------------------*/
+/**
+ * @brief Converts a raw reading to raw * NUM / DEN + OFFSET, truncated toward zero like the integer cast
+ *        of the equivalent double expression.
+ *
+ * The factor is stored as a Q32.32 multiplier rounded up, so the conversion is one 32x64 bit multiply and a shift.
+ * Rounding up keeps exact results from truncating to one below, and the error stays under one output LSB
+ * as long as |raw| * DEN < 2^32.
+ */
+template<int64_t NUM, int64_t DEN, int32_t OFFSET = 0>
+struct SensorScale
+{
+    static_assert(NUM > 0 && DEN > 0, "Scale factor must be positive, negate the result instead");
+    static_assert(NUM < (INT64_C(1) << 30), "Scale factor numerator too large for the Q32.32 multiplier");
+
+    static constexpr int64_t MULT = ((NUM << 32) + DEN - 1) / DEN;
+
+    static inline int32_t Apply(int32_t raw)
+    {
+        int64_t q = (int64_t)raw * MULT + (int64_t)OFFSET * (INT64_C(1) << 32);    // Multiplied rather than shifted, OFFSET may be negative
+        return (q >= 0) ? (int32_t)(q >> 32) : -(int32_t)((-q) >> 32);
+    }
+};
+
+/* Sensor Scales -------------------------------------------------------------*/
+// LSM9DS1 at +/- 16G, 245 DPS and 4 gauss
+using ImuAccelScale = SensorScale<183, 250>;    // 0.732 mg/LSB
+using ImuGyroScale = SensorScale<35, 4>;        // 8.75 mdps/LSB
+using ImuMagScale = SensorScale<7, 50>;         // 0.14 mgauss/LSB
+
+// 12 bit ADC with a 3.3V reference
+constexpr int64_t ADC_FULL_SCALE_MV = 3300;
+constexpr int64_t ADC_MAX_COUNT = 4095;
+
+// Battery voltage through a 1:4 divider, mV
+using BatteryVoltageScale = SensorScale<ADC_FULL_SCALE_MV * 4, ADC_MAX_COUNT>;
+
+// Pressure transducer, 250 PSI/V after undoing the 249:379 divider, offset -125 PSI, PSI * 1000
+using PressureTransducerScale = SensorScale<ADC_FULL_SCALE_MV * 250 * 379, ADC_MAX_COUNT * 249, -125000>;
+
+#endif    // SOAR_SENSOR_SCALE_HPP_
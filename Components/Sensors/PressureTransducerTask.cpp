@@ -21,6 +21,8 @@
 #include "Task.hpp"
 #include <time.h>
 #include "DMBProtocolTask.hpp"
+#include "TelemetryAggregator.hpp"
+#include "SensorScale.hpp"
 
 
 /* Macros --------------------------------------------------------------------*/
@@ -30,6 +32,7 @@
 /* Constants -----------------------------------------------------------------*/
 
 /* Variables -----------------------------------------------------------------*/
+PressureTransducerTask PressureTransducerTask::inst_;
 
 /* Prototypes ----------------------------------------------------------------*/
 
@@ -37,9 +40,9 @@
 /**
  * @brief Default constructor, sets and sets up storage for member variables
  */
-PressureTransducerTask::PressureTransducerTask() : Task(TASK_PRESSURE_TRANSDUCER_QUEUE_DEPTH_OBJS)
+PressureTransducerTask::PressureTransducerTask() : Task(&evtQueue_)
 {
-    data = (PressureTransducerData*)soar_malloc(sizeof(PressureTransducerData));
+    qEvtQueue->EnableCoalescing();
 }
 
 /**
@@ -51,16 +54,17 @@ void PressureTransducerTask::InitTask()
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize PT task twice");
 
     // Start the task
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)PressureTransducerTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)PressureTransducerTask::RunTask,
             (const char*)"PTTask",
-            (uint16_t)TASK_PRESSURE_TRANSDUCER_STACK_DEPTH_WORDS,
+            (uint32_t)TASK_PRESSURE_TRANSDUCER_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)TASK_PRESSURE_TRANSDUCER_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
     //Ensure creation succeded
-    SOAR_ASSERT(rtValue == pdPASS, "PressureTransducerTask::InitTask() - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "PressureTransducerTask::InitTask() - xTaskCreateStatic() failed");
 }
 
 /**
@@ -69,15 +73,8 @@ void PressureTransducerTask::InitTask()
  */
 void PressureTransducerTask::Run(void * pvParams)
 {
-    while (1) {
-        Command cm;
-
-        //Wait forever for a command
-        qEvtQueue->ReceiveWait(cm);
-
-        //Process the command
-        HandleCommand(cm);
-    }
+    //Handle commands in batches, duplicate requests in a backlog are coalesced by the queue
+    RunBatchedEventLoop();
 }
 
 /**
@@ -86,13 +83,11 @@ void PressureTransducerTask::Run(void * pvParams)
  */
 void PressureTransducerTask::HandleCommand(Command& cm)
 {
-    //TODO: Since this task will stall for a few milliseconds, we may need a way to eat the whole queue (combine similar eg. REQUEST commands and eat to WDG command etc)
-    //TODO: Maybe a HandleEvtQueue instead that takes in the whole queue and eats the whole thing in order of non-blocking to blocking
-
     //Switch for the GLOBAL_COMMAND
     switch (cm.GetCommand()) {
     case REQUEST_COMMAND: {
         HandleRequestCommand(cm.GetTaskCommand());
+        break;
     }
     case TASK_SPECIFIC_COMMAND: {
         break;
@@ -118,10 +113,13 @@ void PressureTransducerTask::HandleRequestCommand(uint16_t taskCommand)
         SamplePressureTransducer();
         break;
     case PT_REQUEST_TRANSMIT:
-    	TransmitProtocolPressureData();
+    	if (TelemetryAggregator::IsEnabled())
+    	    TelemetryAggregator::UpdatePressureTransducer(data);
+    	else
+    	    TransmitProtocolPressureData();
         break;
     case PT_REQUEST_DEBUG:
-        SOAR_PRINT("|PT_TASK| Pressure (PSI): %d.%d, MCU Timestamp: %u\r\n", data->pressure_1 / 1000, data->pressure_1 % 1000,
+        SOAR_PRINT("|PT_TASK| Pressure (PSI): %d.%d, MCU Timestamp: %u\r\n", data.pressure_1 / 1000, data.pressure_1 % 1000,
         timestampPT);
         break;
     default:
@@ -151,10 +149,7 @@ void ADC_Select_CH9 (void)
 void PressureTransducerTask::SamplePressureTransducer()
 {
 	static const int PT_VOLTAGE_ADC_POLL_TIMEOUT = 50;
-	static const double PRESSURE_SCALE = 1.5220883534136546; // Value to scale to original voltage value
-	double adcVal[1] = {};
-	double pressureTransducerValue1 = 0;
-	double vi = 0;
+	uint32_t adcVal[1] = {};
 
 	/* Functions -----------------------------------------------------------------*/
 	ADC_Select_CH9();
@@ -163,10 +158,8 @@ void PressureTransducerTask::SamplePressureTransducer()
 		adcVal[0] = HAL_ADC_GetValue(&hadc1); // Get ADC Value
 		HAL_ADC_Stop(&hadc1);
 		}
-	vi = ((3.3/4095) * (adcVal[0])); // Converts 12 bit ADC value into voltage
-	pressureTransducerValue1 = (250 * (vi * PRESSURE_SCALE) - 125) * 1000; // Multiply by 1000 to keep decimal places
-	data->pressure_1 = (int32_t) pressureTransducerValue1; // Pressure in PSI
-//	SOAR_PRINT("The pressure is : %d \n\n", (int32_t) pressureTransducerValue1);
+	data.pressure_1 = PressureTransducerScale::Apply(adcVal[0]); // Pressure in PSI * 1000
+//	SOAR_PRINT("The pressure is : %d \n\n", data.pressure_1);
 }
 
 /**
@@ -180,12 +173,12 @@ void PressureTransducerTask::TransmitProtocolPressureData()
 	msg.set_source(Proto::Node::NODE_DMB);
 	msg.set_target(Proto::Node::NODE_RCU);
 	Proto::DmbPressure pressData;
-	pressData.set_upper_pv_pressure(data->pressure_1);
+	pressData.set_upper_pv_pressure(data.pressure_1);
 	msg.set_dmbPressure(pressData);
 
 	EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE> writeBuffer;
 	msg.serialize(writeBuffer);
 
     // Send the barometer data
-    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY);
+    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY, RADIO_MSG_CLASS_SENSOR_HIGH_RATE);
 }
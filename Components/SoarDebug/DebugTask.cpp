@@ -8,6 +8,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "DebugTask.hpp"
 #include "Command.hpp"
+#include "MemoryPool.hpp"
 #include "Utils.hpp"
 #include <cstring>
 
@@ -28,6 +29,12 @@
 #include "FlashTask.hpp"
 #include "HDITask.hpp"
 #include "MEVManager.hpp"
+#include "TelemetryTask.hpp"
+#include "UARTTask.hpp"
+#include "RadioLinkScheduler.hpp"
+#include "TelemetryAggregator.hpp"
+#include "DeltaTelemetry.hpp"
+#include "QueueHealthTelemetry.hpp"
 
 /* Macros --------------------------------------------------------------------*/
 
@@ -37,8 +44,10 @@
 constexpr uint8_t DEBUG_TASK_PERIOD = 100;
 
 /* Variables -----------------------------------------------------------------*/
+DebugTask DebugTask::inst_;
 
 /* Prototypes ----------------------------------------------------------------*/
+static void PrintQueueStats(const char* name, const Queue* queue);
 
 /* HAL Callbacks ----------------------------------------------------------------*/
 /**
@@ -56,7 +65,7 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart)
 /**
  * @brief Constructor, sets all member variables
  */
-DebugTask::DebugTask() : Task(TASK_DEBUG_QUEUE_DEPTH_OBJS), kUart_(UART::Debug)
+DebugTask::DebugTask() : Task(&evtQueue_), kUart_(UART::Debug)
 {
     memset(debugBuffer, 0, sizeof(debugBuffer));
     debugMsgIdx = 0;
@@ -72,16 +81,17 @@ void DebugTask::InitTask()
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize Debug task twice");
 
     // Start the task
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)DebugTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)DebugTask::RunTask,
             (const char*)"DebugTask",
-            (uint16_t)TASK_DEBUG_STACK_DEPTH_WORDS,
+            (uint32_t)TASK_DEBUG_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)TASK_DEBUG_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
     //Ensure creation succeded
-    SOAR_ASSERT(rtValue == pdPASS, "DebugTask::InitTask - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "DebugTask::InitTask - xTaskCreateStatic() failed");
 }
 
 // TODO: Only run thread when appropriate GPIO pin pulled HIGH (or by define)
@@ -90,7 +100,7 @@ void DebugTask::InitTask()
  */
 void DebugTask::Run(void * pvParams)
 {
-    // Arm the interrupt
+    // Start receiving
     ReceiveData();
 
     while (1) {
@@ -119,7 +129,37 @@ void DebugTask::HandleDebugMessage(const char* msg)
         // Get parameter and send as a control action to flight task
         int32_t state = ExtractIntParameter(msg, 4);
         if (state != ERRVAL && state > 0 && state < UINT16_MAX)
-            FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, state));
+            FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, state));
+    }
+    else if (strncmp(msg, "radiorate ", 10) == 0) {
+        // Set the radio link byte rate
+        int32_t rate = ExtractIntParameter(msg, 10);
+        if (rate != ERRVAL && rate > 0) {
+            RadioLinkScheduler::SetRate(rate);
+            SOAR_PRINT("Radio link rate set to %d B/s\n", rate);
+        }
+    }
+    else if (strncmp(msg, "baroosr ", 8) == 0) {
+        // Set the barometer over-sampling ratio, 256 to 4096
+        int32_t val = ExtractIntParameter(msg, 8);
+        uint16_t osrCmd = BARO_SET_OSR_256;
+        while (osrCmd < BARO_SET_OSR_4096 && (256 << (osrCmd - BARO_SET_OSR_256)) < val)
+            osrCmd++;
+        if (val != ERRVAL && (256 << (osrCmd - BARO_SET_OSR_256)) == val)
+            BarometerTask::Inst().SendCommand(Command(TASK_SPECIFIC_COMMAND, osrCmd));
+        else
+            SOAR_PRINT("Barometer OSR must be 256, 512, 1024, 2048 or 4096\n");
+    }
+    else if (strncmp(msg, "imuodr ", 7) == 0) {
+        // Set the IMU accel/gyro output data rate, 119 to 952 Hz
+        int32_t val = ExtractIntParameter(msg, 7);
+        uint16_t odrCmd = IMU_SET_ODR_119;
+        while (odrCmd < IMU_SET_ODR_952 && (119 << (odrCmd - IMU_SET_ODR_119)) < val)
+            odrCmd++;
+        if (val != ERRVAL && (119 << (odrCmd - IMU_SET_ODR_119)) == val)
+            IMUTask::Inst().SendCommand(Command(TASK_SPECIFIC_COMMAND, odrCmd));
+        else
+            SOAR_PRINT("IMU ODR must be 119, 238, 476 or 952\n");
     }
     else if (strncmp(msg, "setradiohb ", 11) == 0) {
         // Send the heartbeat set to the watchdog task, where val is seconds
@@ -140,6 +180,48 @@ void DebugTask::HandleDebugMessage(const char* msg)
         SOAR_PRINT("Lowest Ever Heap Size\t: %d Bytes\n", xPortGetMinimumEverFreeHeapSize());
         SOAR_PRINT("Debug Task Runtime  \t: %d ms\n\n", TICKS_TO_MS(xTaskGetTickCount()));
     }
+    else if (strcmp(msg, "poolstats") == 0) {
+        // Print the command memory pool usage
+        MemoryPool::PrintStats();
+    }
+    else if (strcmp(msg, "queuestats") == 0) {
+        // Print the event queue statistics of every task
+        SOAR_PRINT("\n\t-- Queue Stats (latency bins: 0, 1, 2-3, ... ticks) --\n");
+        for (uint8_t i = 0; i < TELEMETRY_QUEUE_COUNT; i++)
+            PrintQueueStats(QueueHealthTelemetry::GetQueueName((TELEMETRY_QUEUE)i), QueueHealthTelemetry::GetQueue((TELEMETRY_QUEUE)i));
+        SOAR_PRINT("\n");
+    }
+    else if (strcmp(msg, "uartstats") == 0) {
+        // Print the transmit statistics of every UART channel
+        static const char* const channelNames[UART_TASK_NUM_CHANNELS] = { "Debug", "Radio", "PBB" };
+        SOAR_PRINT("\n\t-- UART Tx Stats --\n");
+        for (uint8_t i = 0; i < UART_TASK_NUM_CHANNELS; i++) {
+            UARTChannelStats stats;
+            UARTTask::Inst().GetChannelStats((UART_TASK_CHANNEL)i, stats);
+            SOAR_PRINT("%-6s: %d bytes, %d frames in %d transfers, %d failed, %d dropped\n",
+                channelNames[i], stats.bytesSent, stats.framesSent, stats.transfers, stats.framesFailed, stats.framesDropped);
+        }
+        SOAR_PRINT("\n");
+    }
+    else if (strcmp(msg, "telemframe") == 0) {
+        // Toggle between one aggregated telemetry frame per period and one message per sensor
+        TelemetryAggregator::SetEnabled(!TelemetryAggregator::IsEnabled());
+        SOAR_PRINT("Aggregated telemetry frame %s\n", TelemetryAggregator::IsEnabled() ? "ENABLED" : "DISABLED");
+    }
+    else if (strcmp(msg, "telemdelta") == 0) {
+        // Toggle delta encoded IMU and barometer streams
+        DeltaTelemetry::SetEnabled(!DeltaTelemetry::IsEnabled());
+        SOAR_PRINT("Delta telemetry streams %s\n", DeltaTelemetry::IsEnabled() ? "ENABLED" : "DISABLED");
+    }
+    else if (strcmp(msg, "telemqueues") == 0) {
+        // Toggle the periodic queue health frame
+        QueueHealthTelemetry::SetEnabled(!QueueHealthTelemetry::IsEnabled());
+        SOAR_PRINT("Queue health telemetry %s\n", QueueHealthTelemetry::IsEnabled() ? "ENABLED" : "DISABLED");
+    }
+    else if (strcmp(msg, "radiostats") == 0) {
+        // Print the radio link budget and per-class statistics
+        RadioLinkScheduler::PrintStats();
+    }
     else if (strcmp(msg, "blinkled") == 0) {
         // Print message
         SOAR_PRINT("Debug 'LED blink' command requested\n");
@@ -276,23 +358,27 @@ void DebugTask::HandleDebugMessage(const char* msg)
 }
 
 /**
- * @brief Receive data, currently receives by arming interrupt
+ * @brief Receive data, starts circular DMA reception so the UART is only serviced per line instead of per byte
  */
 bool DebugTask::ReceiveData()
 {
-    return kUart_->ReceiveIT(&debugRxChar, this);
+    return kUart_->ReceiveDMA(debugDmaRxBuf, sizeof(debugDmaRxBuf), this);
 }
 
 /**
- * @brief Receive data to the buffer
- * @return Whether the debugBuffer is ready or not
+ * @brief Receive a span of data into the debugBuffer, called from the UART and DMA interrupts
+ * @param data Received data
+ * @param len Number of bytes received
  */
-void DebugTask::InterruptRxData(uint8_t errors)
+void DebugTask::InterruptRxSpan(const uint8_t* data, uint16_t len, uint8_t errors)
 {
-    // If we already have an unprocessed debug message, ignore this byte
-    if (!isDebugMsgReady) {
+    for (uint16_t i = 0; i < len; i++) {
+        // If we already have an unprocessed debug message, ignore the rest of the data
+        if (isDebugMsgReady)
+            break;
+
         // Check byte for end of message - note if using termite you must turn on append CR
-        if (debugRxChar == '\r' || debugMsgIdx == DEBUG_RX_BUFFER_SZ_BYTES) {
+        if (data[i] == '\r' || debugMsgIdx == DEBUG_RX_BUFFER_SZ_BYTES) {
             // Null terminate and process
             debugBuffer[debugMsgIdx++] = '\0';
             isDebugMsgReady = true;
@@ -308,12 +394,9 @@ void DebugTask::InterruptRxData(uint8_t errors)
             }
         }
         else {
-            debugBuffer[debugMsgIdx++] = debugRxChar;
+            debugBuffer[debugMsgIdx++] = data[i];
         }
     }
-
-    //Re-arm the interrupt
-    ReceiveData();
 }
 
 /* Helper Functions --------------------------------------------------------------*/
@@ -339,3 +422,21 @@ int32_t DebugTask::ExtractIntParameter(const char* msg, uint16_t identifierLen)
 
     return val;
 }
+
+/**
+ * @brief Prints the statistics of a single task event queue
+ * @param name Name to print for the queue
+ * @param queue Queue to print the statistics of
+ */
+static void PrintQueueStats(const char* name, const Queue* queue)
+{
+    QueueStats stats;
+    queue->GetStats(stats);
+
+    SOAR_PRINT("%-10s: %2d/%2d waiting, high %2d, sent %d, failed %d, dropped oldest %d, coalesced %d, latency",
+        name, queue->GetQueueMessageCount(), queue->GetQueueDepth(), stats.depthHighWatermark,
+        stats.sendCount, stats.failedSendCount, stats.droppedOldestCount, stats.coalescedCount);
+    for (uint8_t i = 0; i < QUEUE_LATENCY_HISTOGRAM_BINS; i++)
+        SOAR_PRINT(" %d", stats.latencyHistogram[i]);
+    SOAR_PRINT("\n");
+}
@@ -19,20 +19,20 @@ enum DEBUG_TASK_COMMANDS {
 
 /* Macros ------------------------------------------------------------------*/
 constexpr uint16_t DEBUG_RX_BUFFER_SZ_BYTES = 16;
+constexpr uint16_t DEBUG_RX_DMA_BUFFER_SZ_BYTES = 64;
 
 /* Class ------------------------------------------------------------------*/
 class DebugTask : public Task, public UARTReceiverBase
 {
 public:
     static DebugTask& Inst() {
-        static DebugTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
 
-    // Interrupt receive callback
-    void InterruptRxData(uint8_t errors);
+    // DMA receive callback
+    void InterruptRxSpan(const uint8_t* data, uint16_t len, uint8_t errors);
 
 protected:
     static void RunTask(void* pvParams) { DebugTask::Inst().Run(pvParams); } // Static Task Interface, passes control to the instance Run();
@@ -53,7 +53,7 @@ protected:
     uint8_t debugMsgIdx;
     bool isDebugMsgReady;
 
-    uint8_t debugRxChar; // Character received from UART Interrupt
+    uint8_t debugDmaRxBuf[DEBUG_RX_DMA_BUFFER_SZ_BYTES]; // Circular buffer the UART Rx DMA writes to
 
     UARTDriver* const kUart_; // UART Driver
 
@@ -61,6 +61,12 @@ private:
     DebugTask(); // Private constructor
     DebugTask(const DebugTask&);                    // Prevent copy-construction
     DebugTask& operator=(const DebugTask&);            // Prevent assignment
+
+    static DebugTask inst_;    // Singleton instance, defined in the .cpp
+
+    // Static storage
+    StaticQueue<TASK_DEBUG_QUEUE_DEPTH_OBJS> evtQueue_;    // Event queue storage
+    TaskStorage<TASK_DEBUG_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_SYSTEM_DEBUG_TASK_HPP_
@@ -12,6 +12,9 @@
 #include "WatchdogTask.hpp"
 #include "TelemetryTask.hpp"
 
+/* Static Variable Init ------------------------------------------------------------------*/
+DMBProtocolTask DMBProtocolTask::inst_;
+
 /**
  * @brief Initialize the DMBProtocolTask
  */
@@ -21,16 +24,17 @@ void DMBProtocolTask::InitTask()
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize Protocol task twice");
 
     // Start the task
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)DMBProtocolTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)DMBProtocolTask::RunTask,
             (const char*)"ProtocolTask",
-            (uint16_t)TASK_PROTOCOL_STACK_DEPTH_WORDS,
+            (uint32_t)TASK_PROTOCOL_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)TASK_PROTOCOL_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
     //Ensure creation succeded
-    SOAR_ASSERT(rtValue == pdPASS, "ProtocolTask::InitTask - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "ProtocolTask::InitTask - xTaskCreateStatic() failed");
 }
 
 /**
@@ -65,61 +69,61 @@ void DMBProtocolTask::HandleProtobufCommandMessage(EmbeddedProto::ReadBufferFixe
     switch (msg.get_dmb_command().get_command_enum())
     {
     case Proto::DmbCommand::Command::RSC_ANY_TO_ABORT:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_ANY_TO_ABORT));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_ANY_TO_ABORT));
         break;
     case Proto::DmbCommand::Command::RSC_OPEN_VENT:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_OPEN_VENT));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_OPEN_VENT));
         break;
     case Proto::DmbCommand::Command::RSC_CLOSE_VENT:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_CLOSE_VENT));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_CLOSE_VENT));
         break;
     case Proto::DmbCommand::Command::RSC_OPEN_DRAIN:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_OPEN_DRAIN));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_OPEN_DRAIN));
         break;
     case Proto::DmbCommand::Command::RSC_CLOSE_DRAIN:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_CLOSE_DRAIN));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_CLOSE_DRAIN));
         break;
     case Proto::DmbCommand::Command::RSC_MEV_CLOSE:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_MEV_CLOSE));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_MEV_CLOSE));
         break;
     case Proto::DmbCommand::Command::RSC_GOTO_FILL:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_GOTO_FILL));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_GOTO_FILL));
         break;
     case Proto::DmbCommand::Command::RSC_ARM_CONFIRM_1:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_ARM_CONFIRM_1));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_ARM_CONFIRM_1));
         break;
     case Proto::DmbCommand::Command::RSC_ARM_CONFIRM_2:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_ARM_CONFIRM_2));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_ARM_CONFIRM_2));
         break;
     case Proto::DmbCommand::Command::RSC_GOTO_ARM:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_GOTO_ARM));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_GOTO_ARM));
         break;
     case Proto::DmbCommand::Command::RSC_GOTO_PRELAUNCH:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_GOTO_PRELAUNCH));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_GOTO_PRELAUNCH));
         break;
     case Proto::DmbCommand::Command::RSC_POWER_TRANSITION_ONBOARD:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_POWER_TRANSITION_ONBOARD));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_POWER_TRANSITION_ONBOARD));
         break;
     case Proto::DmbCommand::Command::RSC_POWER_TRANSITION_EXTERNAL:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_POWER_TRANSITION_EXTERNAL));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_POWER_TRANSITION_EXTERNAL));
         break;
     case Proto::DmbCommand::Command::RSC_GOTO_IGNITION:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_GOTO_IGNITION));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_GOTO_IGNITION));
         break;
     case Proto::DmbCommand::Command::RSC_IGNITION_TO_LAUNCH: // This is the ignition confirmation (we need a button to send this)
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_IGNITION_TO_LAUNCH));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_IGNITION_TO_LAUNCH));
         break;
     case Proto::DmbCommand::Command::RSC_TEST_MEV_DISABLE:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_TEST_MEV_DISABLE));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_TEST_MEV_DISABLE));
         break;
     case Proto::DmbCommand::Command::RSC_TEST_MEV_ENABLE:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_TEST_MEV_ENABLE));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_TEST_MEV_ENABLE));
         break;
     case Proto::DmbCommand::Command::RSC_TEST_MEV_OPEN:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_TEST_MEV_OPEN));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_TEST_MEV_OPEN));
         break;
     case Proto::DmbCommand::Command::RSC_GOTO_TEST:
-        FlightTask::Inst().SendCommand(Command(CONTROL_ACTION, (uint16_t)RSC_GOTO_TEST));
+        FlightTask::Inst().SendPriorityCommand(Command(CONTROL_ACTION, (uint16_t)RSC_GOTO_TEST));
         break;
     default:
         break;
@@ -143,7 +147,7 @@ void DMBProtocolTask::HandleProtobufControlMesssage(EmbeddedProto::ReadBufferFix
     if(msg.has_hb()) {
         // This is a heartbeat message, update the heartbeat
         SOAR_PRINT("PROTO-INFO: Received Heartbeat Message\n");
-        WatchdogTask::Inst().SendCommand(Command(HEARTBEAT_COMMAND, (uint16_t)RADIOHB_REQUEST));
+        WatchdogTask::Inst().SendPriorityCommand(Command(HEARTBEAT_COMMAND, (uint16_t)RADIOHB_REQUEST));
     }
     else if(msg.has_ping()) {
         // This is a ping message, respond with an ack
@@ -154,7 +158,7 @@ void DMBProtocolTask::HandleProtobufControlMesssage(EmbeddedProto::ReadBufferFix
         ackResponse.set_ack(ack);
         EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE> writeBuf;
         ackResponse.serialize(writeBuf);
-        DMBProtocolTask::SendProtobufMessage(writeBuf, Proto::MessageID::MSG_CONTROL);
+        DMBProtocolTask::SendProtobufMessage(writeBuf, Proto::MessageID::MSG_CONTROL, RADIO_MSG_CLASS_CONTROL);
     }
     else if(msg.has_sys_ctrl()) {
 		// This is a system command, handle it
@@ -10,6 +10,10 @@
 #include "Task.hpp"
 #include "SystemDefines.hpp"
 #include "UARTTask.hpp"
+#include "RadioLinkScheduler.hpp"
+
+/* Macros ------------------------------------------------------------------*/
+constexpr uint16_t RADIO_FRAME_OVERHEAD_BYTES = 3;    // Message ID and CRC16 added by ProtocolTask before COBS encoding
 
 /* Enums ------------------------------------------------------------------*/
 
@@ -18,15 +22,20 @@ class DMBProtocolTask : public ProtocolTask
 {
 public:
     static DMBProtocolTask& Inst() {
-        static DMBProtocolTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
 
-    static void SendProtobufMessage(EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE>& writeBuffer, Proto::MessageID msgId)
+    // Sends a message to the RCU if the radio link budget allows it for the message class, otherwise drops it (counted in the link stats)
+    // Returns false if the message was dropped by the link budget
+    static bool SendProtobufMessage(EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE>& writeBuffer, Proto::MessageID msgId, RADIO_MSG_CLASS msgClass)
     {
+        if (!RadioLinkScheduler::Admit(msgClass, GET_COBS_MAX_LEN(writeBuffer.get_size() + RADIO_FRAME_OVERHEAD_BYTES)))
+            return false;
+
         Inst().ProtocolTask::SendProtobufMessage(writeBuffer, msgId);
+        return true;
     }
 
 protected:
@@ -43,6 +52,11 @@ private:
     DMBProtocolTask();        // Private constructor
     DMBProtocolTask(const DMBProtocolTask&);                        // Prevent copy-construction
     DMBProtocolTask& operator=(const DMBProtocolTask&);            // Prevent assignment
+
+    static DMBProtocolTask inst_;    // Singleton instance, defined in the .cpp
+
+    // Static storage
+    TaskStorage<TASK_PROTOCOL_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_DMBPROTOCOL_HPP_
@@ -11,6 +11,102 @@
 #include "UARTTask.hpp"
 #include "MEVManager.hpp"
 
+/* Structs -------------------------------------------------------------------*/
+// Top level fields of an encoded TelemetryMessage needed to route it
+struct EncodedTelemetryHeader
+{
+    uint32_t source;                    // Source node, 0 if the field is not present (proto3 default)
+    uint32_t target;                    // Target node, 0 if the field is not present
+    uint8_t* targetValue;               // Start of the encoded target value, nullptr if the field is not present
+    uint8_t targetValueLen;             // Length of the encoded target varint
+    bool hasCombustionControlStatus;
+};
+
+/* Static Variable Init ------------------------------------------------------------------*/
+PBBRxProtocolTask PBBRxProtocolTask::inst_;
+
+/* Helpers -------------------------------------------------------------------*/
+/**
+ * @brief Reads a protobuf varint, only the low 32 bits are kept
+ * @param pos Read position, advanced past the varint
+ * @param end End of the data
+ * @param value Output value
+ * @return false if the varint runs past the end of the data or is longer than 10 bytes
+ */
+static bool ReadVarint(uint8_t*& pos, const uint8_t* end, uint32_t& value)
+{
+    value = 0;
+    for (uint8_t i = 0; i < 10 && pos < end; i++) {
+        uint8_t b = *pos++;
+        if (i < 5)
+            value |= (uint32_t)(b & 0x7F) << (7 * i);
+        if ((b & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Walks the top level fields of an encoded TelemetryMessage without decoding any sub-message
+ * @return false if the message is malformed, in which case the full decode is left to handle it
+ */
+static bool ScanEncodedTelemetry(uint8_t* data, uint32_t size, EncodedTelemetryHeader& header)
+{
+    constexpr uint32_t SOURCE_FIELD = static_cast<uint32_t>(Proto::TelemetryMessage::FieldNumber::SOURCE);
+    constexpr uint32_t TARGET_FIELD = static_cast<uint32_t>(Proto::TelemetryMessage::FieldNumber::TARGET);
+    constexpr uint32_t COMBUSTION_CONTROL_STATUS_FIELD = static_cast<uint32_t>(Proto::TelemetryMessage::FieldNumber::COMBUSTIONCONTROLSTATUS);
+
+    header = {};
+    uint8_t* pos = data;
+    const uint8_t* end = data + size;
+
+    while (pos < end) {
+        uint32_t tag;
+        if (!ReadVarint(pos, end, tag))
+            return false;
+
+        uint32_t field = tag >> 3;
+        uint32_t len;
+        switch (tag & 0x07) {
+        case 0: {    // Varint
+            uint8_t* valueStart = pos;
+            uint32_t value;
+            if (!ReadVarint(pos, end, value))
+                return false;
+            if (field == SOURCE_FIELD) {
+                header.source = value;
+            }
+            else if (field == TARGET_FIELD) {
+                header.target = value;
+                header.targetValue = valueStart;
+                header.targetValueLen = (uint8_t)(pos - valueStart);
+            }
+            continue;
+        }
+        case 1:      // 64 bit
+            len = 8;
+            break;
+        case 2:      // Length delimited, sub-messages are skipped whole
+            if (!ReadVarint(pos, end, len))
+                return false;
+            if (field == COMBUSTION_CONTROL_STATUS_FIELD)
+                header.hasCombustionControlStatus = true;
+            break;
+        case 5:      // 32 bit
+            len = 4;
+            break;
+        default:
+            return false;
+        }
+
+        if (len > (uint32_t)(end - pos))
+            return false;
+        pos += len;
+    }
+
+    return true;
+}
+
 /**
  * @brief Initialize the PBBRxProtocolTask
  */
@@ -20,16 +116,17 @@ void PBBRxProtocolTask::InitTask()
     SOAR_ASSERT(rtTaskHandle == nullptr, "Cannot initialize Protocol task twice");
 
     // Start the task
-    BaseType_t rtValue =
-        xTaskCreate((TaskFunction_t)PBBRxProtocolTask::RunTask,
+    rtTaskHandle =
+        xTaskCreateStatic((TaskFunction_t)PBBRxProtocolTask::RunTask,
             (const char*)"PbbProtocol",
-            (uint16_t)TASK_PROTOCOL_STACK_DEPTH_WORDS,
+            (uint32_t)TASK_PROTOCOL_STACK_DEPTH_WORDS,
             (void*)this,
             (UBaseType_t)TASK_PROTOCOL_PRIORITY,
-            (TaskHandle_t*)&rtTaskHandle);
+            taskStorage_.stack,
+            &taskStorage_.controlBlock);
 
     //Ensure creation succeded
-    SOAR_ASSERT(rtValue == pdPASS, "ProtocolTask::InitTask - xTaskCreate() failed");
+    SOAR_ASSERT(rtTaskHandle != nullptr, "ProtocolTask::InitTask - xTaskCreateStatic() failed");
 }
 
 /**
@@ -63,6 +160,10 @@ void PBBRxProtocolTask::HandleProtobufControlMesssage(EmbeddedProto::ReadBufferF
  */
 void PBBRxProtocolTask::HandleProtobufTelemetryMessage(EmbeddedProto::ReadBufferFixedSize<PROTOCOL_RX_BUFFER_SZ_BYTES>& readBuffer)
 {
+    // Most PBB telemetry is only forwarded, so it is only decoded if something on the DMB needs its contents
+    if (ForwardEncodedTelemetry(readBuffer.get_data_array(), readBuffer.get_size()))
+        return;
+
     Proto::TelemetryMessage msg;
     msg.deserialize(readBuffer);
 
@@ -84,5 +185,47 @@ void PBBRxProtocolTask::HandleProtobufTelemetryMessage(EmbeddedProto::ReadBuffer
     EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE> writeBuffer;
     msg.serialize(writeBuffer);
 
-	DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY);
+	// Valve state from the PBB is kept ahead of its sensor data when the radio link is saturated
+	RADIO_MSG_CLASS msgClass = msg.has_combustionControlStatus() ? RADIO_MSG_CLASS_STATE : RADIO_MSG_CLASS_SENSOR_HIGH_RATE;
+	DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY, msgClass);
+}
+
+/**
+ * @brief Forwards an encoded telemetry message to the RCU without decoding it. A target of DMB is
+ *        rewritten to RCU in place, which only works if both encode to the same number of bytes
+ * @param data Encoded TelemetryMessage, the target is patched in place
+ * @param size Size of the encoded message
+ * @return true if the message was handled, false if it has to be decoded (MEV state, target can't be patched, or malformed)
+ */
+bool PBBRxProtocolTask::ForwardEncodedTelemetry(uint8_t* data, uint32_t size)
+{
+    constexpr uint32_t NODE_DMB = static_cast<uint32_t>(Proto::Node::NODE_DMB);
+    constexpr uint32_t NODE_RCU = static_cast<uint32_t>(Proto::Node::NODE_RCU);
+    static_assert(NODE_RCU < 0x80, "RCU node must encode to a single byte to be patched in place");
+
+    EncodedTelemetryHeader header;
+    if (!ScanEncodedTelemetry(data, size, header))
+        return false;
+
+    // MEVManager needs the decoded combustion control status
+    if (header.hasCombustionControlStatus)
+        return false;
+
+    // Verify the source node is the PBB
+    if (header.source != static_cast<uint32_t>(Proto::Node::NODE_PBB))
+        return true;
+
+    // If the target is the DMB, forward it to the RCU
+    if (header.target == NODE_DMB) {
+        if (header.targetValue == nullptr || header.targetValueLen != 1)
+            return false;
+        *header.targetValue = (uint8_t)NODE_RCU;
+    }
+
+    EmbeddedProto::WriteBufferFixedSize<DEFAULT_PROTOCOL_WRITE_BUFFER_SIZE> writeBuffer;
+    if (!writeBuffer.push(data, size))
+        return false;
+
+    DMBProtocolTask::SendProtobufMessage(writeBuffer, Proto::MessageID::MSG_TELEMETRY, RADIO_MSG_CLASS_SENSOR_HIGH_RATE);
+    return true;
 }
@@ -18,8 +18,7 @@ class PBBRxProtocolTask : public ProtocolTask
 {
 public:
     static PBBRxProtocolTask& Inst() {
-        static PBBRxProtocolTask inst;
-        return inst;
+        return inst_;
     }
 
     void InitTask();
@@ -49,6 +48,8 @@ protected:
     void HandleProtobufCommandMessage(EmbeddedProto::ReadBufferFixedSize<PROTOCOL_RX_BUFFER_SZ_BYTES>& readBuffer);
     void HandleProtobufControlMesssage(EmbeddedProto::ReadBufferFixedSize<PROTOCOL_RX_BUFFER_SZ_BYTES>& readBuffer);
     void HandleProtobufTelemetryMessage(EmbeddedProto::ReadBufferFixedSize<PROTOCOL_RX_BUFFER_SZ_BYTES>& readBuffer);
+
+    bool ForwardEncodedTelemetry(uint8_t* data, uint32_t size);    // Forwards a telemetry message to the RCU without decoding it, false if it must be decoded
     
     // Member variables
 
@@ -56,6 +57,11 @@ private:
     PBBRxProtocolTask();        // Private constructor
     PBBRxProtocolTask(const PBBRxProtocolTask&);                        // Prevent copy-construction
     PBBRxProtocolTask& operator=(const PBBRxProtocolTask&);            // Prevent assignment
+
+    static PBBRxProtocolTask inst_;    // Singleton instance, defined in the .cpp
+
+    // Static storage
+    TaskStorage<TASK_PROTOCOL_STACK_DEPTH_WORDS> taskStorage_;    // Stack and control block for xTaskCreateStatic
 };
 
 #endif    // SOAR_PBBRXPROTOCOL_HPP_
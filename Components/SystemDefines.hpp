@@ -39,6 +39,7 @@
 // FLIGHT PHASE
 constexpr uint8_t FLIGHT_TASK_RTOS_PRIORITY = 3;            // Priority of the flight task
 constexpr uint8_t FLIGHT_TASK_QUEUE_DEPTH_OBJS = 10;        // Size of the flight task queue
+constexpr uint8_t FLIGHT_TASK_PRIORITY_QUEUE_DEPTH_OBJS = 4;    // Size of the flight task high priority lane (control actions)
 constexpr uint16_t FLIGHT_TASK_STACK_DEPTH_WORDS = 512;        // Size of the flight task stack
 
 constexpr uint16_t FLIGHT_PHASE_DISPLAY_FREQ = 1000;    // Display frequency for flight phase information
@@ -46,7 +47,11 @@ constexpr uint16_t FLIGHT_PHASE_DISPLAY_FREQ = 1000;    // Display frequency for
 // UART TASK
 constexpr uint8_t UART_TASK_RTOS_PRIORITY = 2;            // Priority of the uart task
 constexpr uint8_t UART_TASK_QUEUE_DEPTH_OBJS = 10;        // Size of the uart task queue
+constexpr uint8_t UART_TASK_CHANNEL_QUEUE_DEPTH_OBJS = 8;    // Size of each per-UART transmit queue
 constexpr uint16_t UART_TASK_STACK_DEPTH_WORDS = 512;    // Size of the uart task stack
+constexpr uint16_t UART_TASK_TX_DMA_TIMEOUT_MS = 200;    // Max time for one DMA transmit (a full 512 byte radio burst takes ~90ms at 57600 baud)
+constexpr uint16_t UART_TASK_RADIO_BURST_BUFFER_BYTES = 512;    // Max size of one aggregated radio DMA burst
+constexpr uint16_t UART_TASK_RADIO_AGGREGATION_WINDOW_MS = 10;    // Max time a radio frame is held back waiting for others to share its burst
 
 // DEBUG TASK
 constexpr uint8_t TASK_DEBUG_PRIORITY = 2;            // Priority of the debug task
@@ -57,11 +62,18 @@ constexpr uint16_t TASK_DEBUG_STACK_DEPTH_WORDS = 512;        // Size of the deb
 constexpr uint8_t TASK_BAROMETER_PRIORITY = 2;            // Priority of the barometer task
 constexpr uint8_t TASK_BAROMETER_QUEUE_DEPTH_OBJS = 10;        // Size of the barometer task queue
 constexpr uint16_t TASK_BAROMETER_STACK_DEPTH_WORDS = 512;        // Size of the barometer task stack
+constexpr uint32_t BARO_CONVERSION_PERIOD_MS = 10;        // One conversion per period, long enough for OSR 4096 (9.04ms), ~100Hz pressure stream
+constexpr uint8_t BARO_PRESSURE_READINGS_PER_TEMPERATURE = 10;    // Pressure readings compensated with each temperature reading
+constexpr uint16_t BARO_PROM_RETRY_MAX_TICKS = 500;    // Longest wait between PROM reads after CRC failures, in conversion ticks (5s)
 
 // IMU TASK (ACCEL/GYRO/MAGNETO)
 constexpr uint8_t TASK_IMU_PRIORITY = 2;            // Priority of the barometer task
 constexpr uint8_t TASK_IMU_QUEUE_DEPTH_OBJS = 10;        // Size of the barometer task queue
+constexpr uint8_t TASK_IMU_PRIORITY_QUEUE_DEPTH_OBJS = 3;    // Size of the IMU task high priority lane (drain complete, ODR changes)
 constexpr uint16_t TASK_IMU_STACK_DEPTH_WORDS = 512;        // Size of the barometer task stack
+constexpr uint32_t IMU_FIFO_POLL_PERIOD_MS = 20;        // Accel/gyro FIFO drain period, the 32 sample FIFO holds 33ms at the 952Hz ODR
+constexpr uint8_t IMU_MAG_READ_DIVIDER = 5;        // Magnetometer is read every N FIFO polls (~10Hz, its default ODR)
+constexpr bool IMU_FIFO_BATCH_LOGGING_ENABLED = true;        // Log every accel/gyro sample to flash in IMUBatchData records
 
 // GPS TASK
 constexpr uint8_t TASK_GPS_PRIORITY = 2;            // Priority of the barometer task
@@ -71,11 +83,13 @@ constexpr uint16_t TASK_GPS_STACK_DEPTH_WORDS = 896;        // Size of the barom
 // FLASH Task
 constexpr uint8_t FLASH_TASK_RTOS_PRIORITY = 2;            // Priority of the flash task
 constexpr uint8_t FLASH_TASK_QUEUE_DEPTH_OBJS = 10;        // Size of the flash task queue
+constexpr uint8_t FLASH_TASK_PRIORITY_QUEUE_DEPTH_OBJS = 2;    // Size of the flash task high priority lane (state persistence)
 constexpr uint16_t FLASH_TASK_STACK_DEPTH_WORDS = 512;        // Size of the flash task stack
 
 // WATCHDOG Task
 constexpr uint8_t WATCHDOG_TASK_RTOS_PRIORITY = 3;            // Priority of the watchdog task
 constexpr uint8_t WATCHDOG_TASK_QUEUE_DEPTH_OBJS = 10;        // Size of the watchdog task queue
+constexpr uint8_t WATCHDOG_TASK_PRIORITY_QUEUE_DEPTH_OBJS = 2;    // Size of the watchdog task high priority lane (heartbeats)
 constexpr uint16_t WATCHDOG_TASK_STACK_DEPTH_WORDS = 512;        // Size of the watchdog task stack
 
 // HDI Task
@@ -100,6 +114,11 @@ constexpr uint16_t BATTERY_TASK_STACK_DEPTH_WORDS = 512;        // Size of the b
 
 constexpr uint32_t TELEMETRY_DEFAULT_LOGGING_RATE_MS = 500; // Default logging delay for telemetry task
 constexpr uint32_t TELEMETRY_MINIMUM_LOG_PERIOD_MS = 50; // (1000/50 = 20hz) The minimum log period / max log rate
+constexpr bool TELEMETRY_AGGREGATED_FRAME_ENABLED = false; // Send one TelemetryAggregator frame per log period instead of a message per sensor (needs ground support)
+constexpr bool TELEMETRY_DELTA_ENCODING_ENABLED = false; // Send IMU and barometer samples as DeltaTelemetry frames instead of protobuf messages (needs ground support)
+constexpr uint16_t TELEMETRY_DELTA_KEYFRAME_INTERVAL = 10; // Frames per delta stream between keyframes, bounds how long the ground side waits to resync
+constexpr bool TELEMETRY_QUEUE_HEALTH_ENABLED = false; // Send a QueueHealthTelemetry frame every TELEMETRY_QUEUE_HEALTH_LOG_PERIODS log periods (needs ground support)
+constexpr uint8_t TELEMETRY_QUEUE_HEALTH_LOG_PERIODS = 10; // Log periods between queue health frames, 5s at the default logging rate
 
 /* Flash Addresses ------------------------------------------------------------------*/
 // Start of the system storage area (spans 2 sectors)
@@ -120,7 +139,22 @@ constexpr uint32_t SPI_FLASH_LOGGING_STORAGE_START_ADDR = 0xA000;
 /* - Each define / constexpr must be all-caps. Prefer constexpr unless it's a string, or a calculation (eg. mathematical expression being more readable) */
 // RTOS
 constexpr uint8_t DEFAULT_QUEUE_SIZE = 10;                    // Default size of the queue
-constexpr uint16_t MAX_NUMBER_OF_COMMAND_ALLOCATIONS = 100;    // Let's assume ~128B per allocation, 100 x 128B = 12800B = 12.8KB
+constexpr uint8_t QUEUE_LATENCY_HISTOGRAM_BINS = 8;            // Number of log2 bins in the per-queue latency histogram (0, 1, 2-3, ... 64+ ticks)
+constexpr uint16_t MAX_COMMAND_BATCH_SIZE = 8;                // Max commands handled per wake-up by batched task run loops (batch is held on the task stack)
+constexpr uint16_t COMMAND_INLINE_DATA_SIZE_BYTES = 12;        // Payloads up to this size are stored inside the Command (fits BarometerData), each byte is copied on every queue send/receive
+
+// MEMORY POOL (Command payloads, total static size is the sum of blocks x block size = 8KB)
+constexpr uint16_t MEMORY_POOL_16B_NUM_BLOCKS = 32;            // Number of 16 byte blocks (small sensor data, state)
+constexpr uint16_t MEMORY_POOL_32B_NUM_BLOCKS = 16;            // Number of 32 byte blocks
+constexpr uint16_t MEMORY_POOL_64B_NUM_BLOCKS = 16;            // Number of 64 byte blocks (IMU data, short prints)
+constexpr uint16_t MEMORY_POOL_128B_NUM_BLOCKS = 16;        // Number of 128 byte blocks (protocol frames)
+constexpr uint16_t MEMORY_POOL_256B_NUM_BLOCKS = 16;        // Number of 256 byte blocks (debug prints up to DEBUG_PRINT_MAX_SIZE)
+constexpr uint16_t MEMORY_POOL_MAX_HEAP_FALLBACK_ALLOCATIONS = 20;    // Max outstanding allocations that fell through to the RTOS heap before asserting
+constexpr uint32_t HEAP_MIN_FREE_AFTER_INIT_BYTES = 6144;    // RTOS heap that must be left once all tasks are initialized, covers the MemoryPool heap fallbacks
+
+// RADIO LINK (token bucket admission of messages sent to the RCU, see RadioLinkScheduler)
+constexpr uint32_t RADIO_LINK_RATE_BYTES_PER_SEC = 4800;      // Default sustained byte rate, 5760 B/s is the raw rate of the 57600 baud radio UART
+constexpr uint16_t RADIO_LINK_BUCKET_SIZE_BYTES = 1024;        // Max burst in bytes, the budget saved while the link is idle
 
 // DEBUG
 constexpr uint16_t DEBUG_TAKE_MAX_TIME_MS = 500;        // Max time in ms to take the debug semaphore
@@ -13,8 +13,7 @@
 #include "cmsis_os.h"
 #include "main_avionics.hpp"
 #include "SystemDefines.hpp"
-
-#include "etl/crc16_xmodem.h"
+#include "Crc.hpp"
 
 /**
  * @brief Calculates the average from a list of unsigned shorts
@@ -67,53 +66,32 @@ void Utils::readUInt32FromUInt8Array(uint8_t* array, int startIndex, int32_t* va
 
 /**
  * @brief Generates a CRC32 checksum for a given array of data using CRC Peripheral
- * @param data The data to generate the checksum for
+ *        Keeps the values of the original copy-and-pad implementation, which may be checked off-board:
+ *        a whole number of words is followed by one zero word, and a partial last word is left out.
+ *        New code should use Crc32, which zero pads the last word instead.
+ * @param data The data to generate the checksum for, does not need to be aligned
  * @param size The size of the data array in uint8_t
  */
 uint32_t Utils::getCRC32Aligned(uint8_t* data, uint32_t size)
 {
-    // Figure out the number of bytes to pad by
-    uint8_t pad = 0;
-
-    // If the buffer is not a multiple of 4 bytes, then we need to pad the buffer by the remaining bytes
-    if(size % 4 == 0)
-        pad = 4 - (size % 4);
-
-    // Generate a buffer padded to uint32_t
-    uint32_t buffer[(size + pad) / 4];
-    uint8_t* tempPtr = (uint8_t*)(&buffer[0]);
-
-    // Bytewise copy and pad
-    memcpy(tempPtr, data, size);
-    memset(tempPtr + size, 0, pad);
+    static const uint8_t ZERO_WORD[4] = {};
 
-    // TODO: TEST THIS THING, also note there's a more efficient way (0-copy) that just involves loop accumulating 4x uint8_t's into 1x uint32_t's but this is more readable, ish
-    // TODO: To be fair, G++ is very good at compiling memcpy though, so honestly other than instantaneous stack usage this may actually be more efficient
-    //SOAR_PRINT("Warning, HCRC is not tested!\n");
-
-    // Calculate the CRC32
-    return HAL_CRC_Calculate(SystemHandles::CRC_Handle, (uint32_t*)buffer, (size+pad)/4);
+    Crc32 crc;
+    crc.Add(data, size - (size % 4));
+    if (size % 4 == 0)
+        crc.Add(ZERO_WORD, sizeof(ZERO_WORD));
+    return crc.Value();
 }
 
 /**
- * @brief Generates CRC16 checksum for a given array of data using etl::crc16
+ * @brief Generates CRC16 (XMODEM) checksum for a given array of data
  * @param data The data to generate the checksum for
  * @param size  The size of the data array in uint8_t
  * @return The CRC16 checksum
  */
 uint16_t Utils::getCRC16(uint8_t* data, uint16_t size)
 {
-    // ETL CRC16 object
-    etl::crc16_xmodem crc;
-    crc.reset();
-
-	// Use etl library to generate CRC16
-	for (uint16_t i = 0; i < size; i++)
-	{
-        crc.add(data[i]);
-	}
-
-    return crc.value();
+    return Crc16::Calculate(data, size);
 }
 
 /**
@@ -158,3 +136,50 @@ int32_t Utils::stringToLong(const char* str)
     return result;
 
 }
+
+/**
+ * @brief Converts a c string holding a decimal number, eg. "-1234.5678", to a fixed point int32_t
+ *        without going through floating point. Digits past the requested decimals are truncated.
+ * @param str The string to convert, must be null terminated
+ * @param decimals Number of decimal places to keep, the result is the value * 10^decimals
+ * @return The converted int32_t, or ERRVAL on an error
+ */
+int32_t Utils::stringToFixed(const char* str, uint8_t decimals)
+{
+    int32_t result = 0;
+    bool negative = false;
+    bool fraction = false;
+    uint8_t fractionDigits = 0;
+
+    if (*str == '-') {
+        negative = true;
+        str++;
+    }
+
+    for (; *str != '\0'; str++)
+    {
+        const uint8_t c = *str;
+        if (c == '.' && !fraction)
+        {
+            fraction = true;
+        }
+        else if (IsAsciiNum(c))
+        {
+            if (fraction && fractionDigits >= decimals)
+                continue;
+            if (fraction)
+                fractionDigits++;
+            result *= 10;
+            result += c - '0';
+        }
+        else
+        {
+            return ERRVAL;
+        }
+    }
+
+    for (; fractionDigits < decimals; fractionDigits++)
+        result *= 10;
+
+    return negative ? -result : result;
+}
@@ -39,7 +39,7 @@ namespace Utils
     void writeInt32ToArray(uint8_t* array, int startIndex, int32_t value);
     void readUInt32FromUInt8Array(uint8_t* array, int startIndex, int32_t* value);
 
-    // CRC
+    // CRC, see Crc.hpp for the incremental versions
     uint32_t getCRC32Aligned(uint8_t* data, uint32_t size);
     uint16_t getCRC16(uint8_t* data, uint16_t size);
 
@@ -52,6 +52,7 @@ namespace Utils
 
     // String to number conversion
     int32_t stringToLong(const char* str);
+    int32_t stringToFixed(const char* str, uint8_t decimals);
 
 }
 
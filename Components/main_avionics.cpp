@@ -60,6 +60,10 @@ void run_main() {
     SOAR_PRINT("System Reset Reason: [TODO]\n"); //TODO: If we want a system reset reason we need to save it on flash
     SOAR_PRINT("Current System Heap Use: %d Bytes\n", xPortGetFreeHeapSize());
     SOAR_PRINT("Lowest Ever Heap Size: %d Bytes\n\n", xPortGetMinimumEverFreeHeapSize());
+
+    // configTOTAL_HEAP_SIZE was sized from host estimates, fail at boot rather than in flight if it is too small
+    SOAR_ASSERT(xPortGetMinimumEverFreeHeapSize() >= HEAP_MIN_FREE_AFTER_INIT_BYTES,
+        "Heap too small, %d bytes free after init, need %d", xPortGetMinimumEverFreeHeapSize(), HEAP_MIN_FREE_AFTER_INIT_BYTES);
     
     // Start the Scheduler
     // Guidelines:
@@ -145,7 +149,12 @@ void soar_assert_debug(bool condition, const char* file, const uint16_t line, co
     // NOTE: https://nadler.com/embedded/newlibAndFreeRTOS.html
 
     // We have an assert fail, we try to take control of the Debug semaphore, and then suspend all other parts of the system
-    if (Global::vaListMutex.Lock(ASSERT_TAKE_MAX_TIME_MS)) {
+    // Before the scheduler starts nothing else can use va_list, and the mutex may not be constructed yet if the assert
+    // fails inside a singleton constructor during static initialization, so it is skipped
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        printMessage = true;
+    }
+    else if (Global::vaListMutex.Lock(ASSERT_TAKE_MAX_TIME_MS)) {
         // We have the mutex, we can now safely print the message
         printMessage = true;
     }
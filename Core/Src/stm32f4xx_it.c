@@ -258,5 +258,76 @@ void UART5_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+/**
+  * @brief This function handles DMA1 stream0 global interrupt (UART5 RX).
+  */
+void DMA1_Stream0_IRQHandler(void)
+{
+  cpp_USART5_RX_DMA_IRQHandler();
+}
+
+/**
+  * @brief This function handles DMA1 stream1 global interrupt (USART3 RX).
+  */
+void DMA1_Stream1_IRQHandler(void)
+{
+  cpp_USART3_RX_DMA_IRQHandler();
+}
+
+/**
+  * @brief This function handles DMA1 stream3 global interrupt (USART3 TX).
+  */
+void DMA1_Stream3_IRQHandler(void)
+{
+  cpp_USART3_TX_DMA_IRQHandler();
+}
+
+/**
+  * @brief This function handles DMA1 stream5 global interrupt (USART2 RX).
+  */
+void DMA1_Stream5_IRQHandler(void)
+{
+  cpp_USART2_RX_DMA_IRQHandler();
+}
+
+/**
+  * @brief This function handles DMA1 stream6 global interrupt (USART2 TX).
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  cpp_USART2_TX_DMA_IRQHandler();
+}
+
+/**
+  * @brief This function handles DMA1 stream7 global interrupt (UART5 TX).
+  */
+void DMA1_Stream7_IRQHandler(void)
+{
+  cpp_USART5_TX_DMA_IRQHandler();
+}
+
+/**
+  * @brief This function handles DMA2 stream0 global interrupt (SPI1 RX, IMU burst reads).
+  */
+void DMA2_Stream0_IRQHandler(void)
+{
+  cpp_IMU_SPI_RX_DMA_IRQHandler();
+}
+
+/**
+  * @brief This function handles DMA2 stream2 global interrupt (USART1 RX).
+  */
+void DMA2_Stream2_IRQHandler(void)
+{
+  cpp_USART1_RX_DMA_IRQHandler();
+}
+
+/**
+  * @brief This function handles DMA2 stream7 global interrupt (USART1 TX).
+  */
+void DMA2_Stream7_IRQHandler(void)
+{
+  cpp_USART1_TX_DMA_IRQHandler();
+}
 
 /* USER CODE END 1 */
@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ * File Name          : Cobs.cpp
+ * Description        : Consistent Overhead Byte Stuffing codec for protocol frames.
+ *    Scans for zero bytes a 32 bit word at a time and supports encoding and
+ *    decoding in place. Output is byte compatible with the SoarProto cobs.c codec.
+ *    See Cobs.hpp for why this is not part of the firmware.
+ ******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "Cobs.hpp"
+
+#include <cstring>     // Support for memcpy, memmove
+
+/* Constants -----------------------------------------------------------------*/
+constexpr uint16_t COBS_MAX_BLOCK_DATA = 254;    // Data bytes in a full block, code 0xFF
+
+/* Helpers -------------------------------------------------------------------*/
+/**
+ * @brief Checks a word for a zero byte without testing each byte
+ * @return true if any of the 4 bytes in the word is 0x00
+ */
+static inline bool HasZeroByte(uint32_t word)
+{
+    return ((word - 0x01010101UL) & ~word & 0x80808080UL) != 0;
+}
+
+/* Functions -----------------------------------------------------------------*/
+/**
+ * @brief Counts the non-zero bytes at the start of data, whole words are tested at once and
+ *        only the word holding the zero is scanned byte by byte
+ * @param data Data to scan, does not need to be aligned (Cortex-M4 handles unaligned word loads)
+ * @param maxLen Number of bytes to scan at most
+ * @return Index of the first 0x00, or maxLen if there is none
+ */
+uint16_t Cobs::ScanNonZero(const uint8_t* data, uint16_t maxLen)
+{
+    uint16_t i = 0;
+    while ((uint16_t)(i + 4) <= maxLen) {
+        uint32_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if (HasZeroByte(word))
+            break;
+        i += 4;
+    }
+
+    while (i < maxLen && data[i] != 0)
+        i++;
+    return i;
+}
+
+/**
+ * @brief Finds the end of a frame in received data
+ * @return Index of the first 0x00 delimiter, or len if there is none
+ */
+uint16_t Cobs::FindDelimiter(const uint8_t* data, uint16_t len)
+{
+    return ScanNonZero(data, len);
+}
+
+/**
+ * @brief COBS encodes data, without the trailing delimiter
+ * @param src Data to encode
+ * @param len Length of the data
+ * @param dst Output, at least len + GET_COBS_ENCODE_HEADROOM(len) bytes. May overlap src if dst is
+ *            at least GET_COBS_ENCODE_HEADROOM(len) bytes before src
+ * @return Encoded length
+ */
+uint16_t Cobs::Encode(const uint8_t* src, uint16_t len, uint8_t* dst)
+{
+    const uint8_t* end = src + len;
+    uint8_t* code = dst;
+    uint8_t* out = dst + 1;
+
+    while (true) {
+        uint16_t remaining = (uint16_t)(end - src);
+        uint16_t run = ScanNonZero(src, (remaining < COBS_MAX_BLOCK_DATA) ? remaining : COBS_MAX_BLOCK_DATA);
+
+        // Copy the whole block at once, memmove as out may still be inside src when encoding in place
+        memmove(out, src, run);
+        out += run;
+        src += run;
+        *code = (uint8_t)(run + 1);
+
+        if (src == end)
+            break;
+
+        // A zero ends the block and is implied by its code, a full block has no zero to skip
+        if (run != COBS_MAX_BLOCK_DATA)
+            src++;
+
+        code = out++;
+    }
+
+    return (uint16_t)(out - dst);
+}
+
+/**
+ * @brief Decodes a COBS frame, without the trailing delimiter
+ * @param src Encoded frame
+ * @param len Length of the encoded frame
+ * @param dst Output, at least len bytes, may be the same buffer as src
+ * @param decodedLen Decoded length, only valid if the frame was well formed
+ * @return false if the frame holds a zero or a block runs past its end
+ */
+bool Cobs::Decode(const uint8_t* src, uint16_t len, uint8_t* dst, uint16_t& decodedLen)
+{
+    const uint8_t* end = src + len;
+    uint8_t* out = dst;
+
+    while (src < end) {
+        uint8_t code = *src++;
+        if (code == 0)
+            return false;
+
+        uint16_t run = code - 1;
+        if (run > (uint16_t)(end - src))
+            return false;
+
+        // Block data must not contain a zero, checking it is the same word scan the encoder uses
+        if (ScanNonZero(src, run) != run)
+            return false;
+
+        memmove(out, src, run);
+        out += run;
+        src += run;
+
+        // Every block but a full one and the last stands for a trailing zero
+        if (code != 0xFF && src < end)
+            *out++ = 0;
+    }
+
+    decodedLen = (uint16_t)(out - dst);
+    return true;
+}
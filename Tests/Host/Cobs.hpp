@@ -0,0 +1,39 @@
+/**
+ ******************************************************************************
+ * File Name          : Cobs.hpp
+ * Description        : Consistent Overhead Byte Stuffing codec for protocol frames.
+ *    Scans for zero bytes a 32 bit word at a time and supports encoding and
+ *    decoding in place. Output is byte compatible with the SoarProto cobs.c codec.
+ *    Candidate replacement for cobs.c, which frames every protocol message inside
+ *    SoarProto's ProtocolTask. It lives with the host tests until SoarProto adopts
+ *    it, CobsTest checks it and CobsBench compares it to the byte-at-a-time codec.
+ ******************************************************************************
+*/
+#ifndef SOAR_TESTS_HOST_COBS_HPP_
+#define SOAR_TESTS_HOST_COBS_HPP_
+/* Includes ------------------------------------------------------------------*/
+#include <cstdint>
+
+/* Macros ------------------------------------------------------------------*/
+#define GET_COBS_ENCODE_HEADROOM(len) (((len) / 254) + 1)    // Max bytes an encoded frame grows by, without the delimiter (see GET_COBS_MAX_LEN)
+
+/* Class -----------------------------------------------------------------*/
+/**
+ * @brief COBS encoder/decoder, the 0x00 frame delimiter is neither written nor expected.
+ *
+ * Encoding in place : place the data GET_COBS_ENCODE_HEADROOM(len) bytes into the buffer and encode
+ *                     with dst at the start of the buffer, the encoder never overtakes its input.
+ * Decoding in place : pass the same buffer as src and dst, decoded data is never longer than the input.
+ */
+class Cobs
+{
+public:
+    static uint16_t Encode(const uint8_t* src, uint16_t len, uint8_t* dst);                    // Returns the encoded length, dst must hold len + GET_COBS_ENCODE_HEADROOM(len)
+    static bool Decode(const uint8_t* src, uint16_t len, uint8_t* dst, uint16_t& decodedLen);  // Returns false on a malformed frame
+    static uint16_t FindDelimiter(const uint8_t* data, uint16_t len);                          // Index of the first 0x00, or len if there is none
+
+private:
+    static uint16_t ScanNonZero(const uint8_t* data, uint16_t maxLen);
+};
+
+#endif    // SOAR_TESTS_HOST_COBS_HPP_
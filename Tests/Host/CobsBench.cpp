@@ -0,0 +1,181 @@
+/**
+ ******************************************************************************
+ * File Name          : CobsBench.cpp
+ * Description        : Encode and decode throughput of the word-at-a-time Cobs codec
+ *    against the byte-at-a-time algorithm of the SoarProto cobs.c codec, over frame
+ *    sizes and zero densities seen on the radio link. Host numbers only show the
+ *    relative cost, absolute times on the Cortex-M4 have to be measured on target.
+ ******************************************************************************
+*/
+#include "Cobs.hpp"
+#include "TestCommon.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/* Constants -----------------------------------------------------------------*/
+constexpr int FRAMES_PER_SET = 64;              // Different frames per measurement, so branch history does not learn one frame
+constexpr uint32_t BYTES_PER_MEASUREMENT = 32 * 1024 * 1024;    // Bytes encoded or decoded per measurement
+
+/* Byte-at-a-time codec ------------------------------------------------------*/
+/**
+ * @brief Byte-at-a-time COBS encoder, the algorithm used by cobs.c
+ */
+static uint16_t ByteEncode(const uint8_t* src, uint16_t len, uint8_t* dst)
+{
+    uint8_t* code = dst;
+    uint8_t* out = dst + 1;
+    uint8_t run = 1;
+
+    for (uint16_t i = 0; i < len; i++) {
+        if (src[i] == 0) {
+            *code = run;
+            code = out++;
+            run = 1;
+            continue;
+        }
+
+        *out++ = src[i];
+        if (++run == 0xFF && i + 1 < len) {
+            *code = run;
+            code = out++;
+            run = 1;
+        }
+    }
+
+    *code = run;
+    return (uint16_t)(out - dst);
+}
+
+/**
+ * @brief Byte-at-a-time COBS decoder, with the same malformed frame checks as Cobs::Decode
+ */
+static bool ByteDecode(const uint8_t* src, uint16_t len, uint8_t* dst, uint16_t& decodedLen)
+{
+    const uint8_t* end = src + len;
+    uint8_t* out = dst;
+
+    while (src < end) {
+        uint8_t code = *src++;
+        if (code == 0 || code - 1 > end - src)
+            return false;
+
+        for (uint8_t i = 1; i < code; i++) {
+            if (*src == 0)
+                return false;
+            *out++ = *src++;
+        }
+
+        if (code != 0xFF && src < end)
+            *out++ = 0;
+    }
+
+    decodedLen = (uint16_t)(out - dst);
+    return true;
+}
+
+/* Helpers -------------------------------------------------------------------*/
+struct FrameSet
+{
+    std::vector<std::vector<uint8_t>> decoded;
+    std::vector<std::vector<uint8_t>> encoded;
+};
+
+/**
+ * @brief Builds random frames of one size, each byte is zero with probability 1 / zeroOneIn (never if 0)
+ */
+static FrameSet MakeFrames(uint16_t size, int zeroOneIn)
+{
+    FrameSet set;
+    for (int f = 0; f < FRAMES_PER_SET; f++) {
+        std::vector<uint8_t> data(size);
+        for (uint8_t& b : data)
+            b = (zeroOneIn != 0 && rand() % zeroOneIn == 0) ? 0 : (uint8_t)(1 + rand() % 255);
+
+        std::vector<uint8_t> encoded(size + GET_COBS_ENCODE_HEADROOM(size));
+        encoded.resize(Cobs::Encode(data.data(), size, encoded.data()));
+
+        set.decoded.push_back(data);
+        set.encoded.push_back(encoded);
+    }
+    return set;
+}
+
+/**
+ * @brief Runs fn over every frame in the set until BYTES_PER_MEASUREMENT bytes were processed
+ * @return Nanoseconds per frame
+ */
+template<typename Fn>
+static double TimePerFrame(const std::vector<std::vector<uint8_t>>& frames, Fn fn)
+{
+    uint32_t rounds = BYTES_PER_MEASUREMENT / ((uint32_t)frames[0].size() * FRAMES_PER_SET) + 1;
+    volatile uint32_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (const std::vector<uint8_t>& frame : frames)
+            sink = sink + fn(frame);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / ((double)rounds * frames.size());
+}
+
+/**
+ * @brief Checks both codecs agree on the set, then times encode and decode of each and prints one row
+ */
+static void BenchFrames(uint16_t size, int zeroOneIn)
+{
+    FrameSet set = MakeFrames(size, zeroOneIn);
+    std::vector<uint8_t> out(size + GET_COBS_ENCODE_HEADROOM(size));
+
+    for (int f = 0; f < FRAMES_PER_SET; f++) {
+        uint16_t len = ByteEncode(set.decoded[f].data(), size, out.data());
+        CHECK(len == set.encoded[f].size() && memcmp(out.data(), set.encoded[f].data(), len) == 0);
+
+        uint16_t decodedLen = 0;
+        CHECK(ByteDecode(set.encoded[f].data(), (uint16_t)set.encoded[f].size(), out.data(), decodedLen));
+        CHECK(decodedLen == size && memcmp(out.data(), set.decoded[f].data(), size) == 0);
+    }
+
+    double byteEncode = TimePerFrame(set.decoded, [&](const std::vector<uint8_t>& d) {
+        return ByteEncode(d.data(), (uint16_t)d.size(), out.data()); });
+    double wordEncode = TimePerFrame(set.decoded, [&](const std::vector<uint8_t>& d) {
+        return Cobs::Encode(d.data(), (uint16_t)d.size(), out.data()); });
+
+    uint16_t decodedLen = 0;
+    double byteDecode = TimePerFrame(set.encoded, [&](const std::vector<uint8_t>& e) {
+        return ByteDecode(e.data(), (uint16_t)e.size(), out.data(), decodedLen) ? decodedLen : 0; });
+    double wordDecode = TimePerFrame(set.encoded, [&](const std::vector<uint8_t>& e) {
+        return Cobs::Decode(e.data(), (uint16_t)e.size(), out.data(), decodedLen) ? decodedLen : 0; });
+
+    char zeros[16];
+    if (zeroOneIn == 0)
+        snprintf(zeros, sizeof(zeros), "none");
+    else
+        snprintf(zeros, sizeof(zeros), "1 in %d", zeroOneIn);
+
+    printf("%5d  %-8s  %8.1f %8.1f %5.2fx   %8.1f %8.1f %5.2fx\n", size, zeros,
+        byteEncode, wordEncode, byteEncode / wordEncode, byteDecode, wordDecode, byteDecode / wordDecode);
+}
+
+int main()
+{
+    srand(1);
+
+    printf("ns per frame           ------- encode -------   ------- decode -------\n");
+    printf(" size  zeros         byte     word  speedup     byte     word  speedup\n");
+
+    // Frame sizes from a heartbeat up to a full aggregated burst, zero densities from packed
+    // sensor values (few zeros) to small integers and padding (many zeros)
+    const uint16_t sizes[] = { 16, 64, 128, 256, 1024 };
+    const int zeroDensities[] = { 0, 64, 8, 2 };
+    for (uint16_t size : sizes) {
+        for (int zeroOneIn : zeroDensities)
+            BenchFrames(size, zeroOneIn);
+    }
+
+    return TestResult("CobsBench");
+}
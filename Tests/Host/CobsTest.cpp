@@ -0,0 +1,172 @@
+/**
+ ******************************************************************************
+ * File Name          : CobsTest.cpp
+ * Description        : Round trip tests for the Cobs codec, checked against known
+ *    vectors and a byte-at-a-time reference encoder with the same output as the
+ *    SoarProto cobs.c codec.
+ ******************************************************************************
+*/
+#include "Cobs.hpp"
+#include "TestCommon.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/* Reference -----------------------------------------------------------------*/
+/**
+ * @brief Byte-at-a-time COBS encoder, the algorithm used by cobs.c
+ */
+static std::vector<uint8_t> ReferenceEncode(const std::vector<uint8_t>& src)
+{
+    std::vector<uint8_t> out(1);
+    size_t codeIdx = 0;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < src.size(); i++) {
+        if (src[i] == 0) {
+            out[codeIdx] = code;
+            codeIdx = out.size();
+            out.push_back(0);
+            code = 1;
+            continue;
+        }
+
+        out.push_back(src[i]);
+        if (++code == 0xFF && i + 1 < src.size()) {
+            out[codeIdx] = code;
+            codeIdx = out.size();
+            out.push_back(0);
+            code = 1;
+        }
+    }
+
+    out[codeIdx] = code;
+    return out;
+}
+
+/* Helpers -------------------------------------------------------------------*/
+static std::vector<uint8_t> Encode(const std::vector<uint8_t>& src)
+{
+    std::vector<uint8_t> out(src.size() + GET_COBS_ENCODE_HEADROOM(src.size()));
+    uint16_t len = Cobs::Encode(src.data(), (uint16_t)src.size(), out.data());
+    out.resize(len);
+    return out;
+}
+
+static std::vector<uint8_t> Range(uint16_t first, uint16_t last)
+{
+    std::vector<uint8_t> v;
+    for (uint16_t b = first; b <= last; b++)
+        v.push_back((uint8_t)b);
+    return v;
+}
+
+static std::vector<uint8_t> Concat(std::vector<uint8_t> a, const std::vector<uint8_t>& b)
+{
+    a.insert(a.end(), b.begin(), b.end());
+    return a;
+}
+
+/**
+ * @brief Encodes then decodes data out of place and in place, checks against the reference encoder
+ */
+static void CheckRoundTrip(const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> encoded = Encode(data);
+    CHECK(encoded == ReferenceEncode(data));
+    CHECK(encoded.size() <= data.size() + GET_COBS_ENCODE_HEADROOM(data.size()));
+    CHECK(Cobs::FindDelimiter(encoded.data(), (uint16_t)encoded.size()) == encoded.size());
+
+    std::vector<uint8_t> decoded(encoded.size());
+    uint16_t decodedLen = 0;
+    CHECK(Cobs::Decode(encoded.data(), (uint16_t)encoded.size(), decoded.data(), decodedLen));
+    decoded.resize(decodedLen);
+    CHECK(decoded == data);
+
+    // In place, the data placed after the encode headroom and decoded in the same buffer
+    uint16_t headroom = GET_COBS_ENCODE_HEADROOM(data.size());
+    std::vector<uint8_t> buffer(headroom + data.size());
+    if (!data.empty())
+        memcpy(buffer.data() + headroom, data.data(), data.size());
+    uint16_t encodedLen = Cobs::Encode(buffer.data() + headroom, (uint16_t)data.size(), buffer.data());
+    CHECK(encodedLen == encoded.size());
+    CHECK(memcmp(buffer.data(), encoded.data(), encodedLen) == 0);
+
+    CHECK(Cobs::Decode(buffer.data(), encodedLen, buffer.data(), decodedLen));
+    CHECK(decodedLen == data.size());
+    CHECK(data.empty() || memcmp(buffer.data(), data.data(), data.size()) == 0);
+}
+
+/* Tests ---------------------------------------------------------------------*/
+static void TestKnownVectors()
+{
+    struct Vector { std::vector<uint8_t> decoded, encoded; };
+    const Vector vectors[] = {
+        { {}, { 0x01 } },
+        { { 0x00 }, { 0x01, 0x01 } },
+        { { 0x00, 0x00 }, { 0x01, 0x01, 0x01 } },
+        { { 0x00, 0x11, 0x00 }, { 0x01, 0x02, 0x11, 0x01 } },
+        { { 0x11, 0x22, 0x00, 0x33 }, { 0x03, 0x11, 0x22, 0x02, 0x33 } },
+        { { 0x11, 0x22, 0x33, 0x44 }, { 0x05, 0x11, 0x22, 0x33, 0x44 } },
+        { { 0x11, 0x00, 0x00, 0x00 }, { 0x02, 0x11, 0x01, 0x01, 0x01 } },
+        { Range(0x01, 0xFE), Concat({ 0xFF }, Range(0x01, 0xFE)) },
+        { Concat({ 0x00 }, Range(0x01, 0xFE)), Concat({ 0x01, 0xFF }, Range(0x01, 0xFE)) },
+        { Range(0x01, 0xFF), Concat(Concat({ 0xFF }, Range(0x01, 0xFE)), { 0x02, 0xFF }) },
+        { Concat(Range(0x02, 0xFF), { 0x00 }), Concat(Concat({ 0xFF }, Range(0x02, 0xFF)), { 0x01, 0x01 }) },
+        { Concat(Range(0x03, 0xFF), { 0x00, 0x01 }), Concat(Concat({ 0xFE }, Range(0x03, 0xFF)), { 0x02, 0x01 }) },
+    };
+
+    for (const Vector& v : vectors) {
+        CHECK(Encode(v.decoded) == v.encoded);
+        CheckRoundTrip(v.decoded);
+    }
+}
+
+static void TestRandomRoundTrip()
+{
+    srand(1);
+    for (int iter = 0; iter < 20000; iter++) {
+        std::vector<uint8_t> data(rand() % 1100);
+        // Vary the zero density so long runs, full blocks and back to back zeros all come up
+        int zeroOneIn = 1 + rand() % 300;
+        for (uint8_t& b : data)
+            b = (rand() % zeroOneIn == 0) ? 0 : (uint8_t)(1 + rand() % 255);
+        CheckRoundTrip(data);
+    }
+}
+
+static void TestMalformedFrames()
+{
+    uint8_t out[16];
+    uint16_t len;
+
+    const uint8_t zeroCode[] = { 0x02, 0x11, 0x00, 0x22 };
+    CHECK(!Cobs::Decode(zeroCode, sizeof(zeroCode), out, len));
+
+    const uint8_t zeroInBlock[] = { 0x04, 0x11, 0x00, 0x22 };
+    CHECK(!Cobs::Decode(zeroInBlock, sizeof(zeroInBlock), out, len));
+
+    const uint8_t blockPastEnd[] = { 0x05, 0x11, 0x22 };
+    CHECK(!Cobs::Decode(blockPastEnd, sizeof(blockPastEnd), out, len));
+}
+
+static void TestFindDelimiter()
+{
+    uint8_t data[64];
+    for (uint16_t pos = 0; pos < sizeof(data); pos++) {
+        memset(data, 0x5A, sizeof(data));
+        data[pos] = 0;
+        CHECK(Cobs::FindDelimiter(data, sizeof(data)) == pos);
+        CHECK(Cobs::FindDelimiter(data, pos) == pos);
+    }
+}
+
+int main()
+{
+    TestKnownVectors();
+    TestRandomRoundTrip();
+    TestMalformedFrames();
+    TestFindDelimiter();
+    return TestResult("CobsTest");
+}
@@ -0,0 +1,145 @@
+/**
+ ******************************************************************************
+ * File Name          : CrcTest.cpp
+ * Description        : Check vectors and chunked vs one-shot tests for Crc16 and
+ *    Crc32, built without USE_HAL_DRIVER so Crc32 uses its software path.
+ ******************************************************************************
+*/
+#include "Crc.hpp"
+#include "TestCommon.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const uint8_t CHECK_STRING[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+/* Reference -----------------------------------------------------------------*/
+/**
+ * @brief Bitwise CRC-16/XMODEM
+ */
+static uint16_t ReferenceCrc16(const uint8_t* data, size_t len)
+{
+    uint16_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * @brief Bitwise CRC-32/MPEG-2 over bytes in order
+ */
+static uint32_t ReferenceCrc32Mpeg2(const uint8_t* data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint32_t)data[i] << 24;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * @brief What the STM32 CRC peripheral gives: the data zero padded to whole little-endian words,
+ *        each word shifted in most significant byte first
+ */
+static uint32_t ReferenceCrc32Stm32(const uint8_t* data, size_t len)
+{
+    std::vector<uint8_t> swapped((len + 3) / 4 * 4, 0);
+    for (size_t i = 0; i < len; i++)
+        swapped[(i & ~(size_t)3) + 3 - (i & 3)] = data[i];
+    return ReferenceCrc32Mpeg2(swapped.data(), swapped.size());
+}
+
+/* Helpers -------------------------------------------------------------------*/
+static std::vector<uint8_t> RandomData(size_t len)
+{
+    std::vector<uint8_t> data(len);
+    for (uint8_t& b : data)
+        b = (uint8_t)rand();
+    return data;
+}
+
+/**
+ * @brief Splits data into random length chunks, including empty ones
+ */
+template<typename CrcT>
+static void AddInChunks(CrcT& crc, const std::vector<uint8_t>& data)
+{
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t chunk = rand() % 10;
+        if (chunk > data.size() - pos)
+            chunk = data.size() - pos;
+        crc.Add(data.data() + pos, (uint32_t)chunk);
+        pos += chunk;
+    }
+}
+
+/* Tests ---------------------------------------------------------------------*/
+static void TestCrc16()
+{
+    CHECK(Crc16::Calculate(CHECK_STRING, sizeof(CHECK_STRING)) == 0x31C3);
+    CHECK(Crc16::Calculate(CHECK_STRING, 0) == 0x0000);
+
+    for (int iter = 0; iter < 2000; iter++) {
+        std::vector<uint8_t> data = RandomData(rand() % 300);
+        uint16_t expected = ReferenceCrc16(data.data(), data.size());
+        CHECK(Crc16::Calculate(data.data(), (uint32_t)data.size()) == expected);
+
+        Crc16 chunked;
+        AddInChunks(chunked, data);
+        CHECK(chunked.Value() == expected);
+
+        chunked.Reset();
+        CHECK(chunked.Value() == 0);
+    }
+}
+
+static void TestCrc32()
+{
+    // Validates the reference against the published CRC-32/MPEG-2 check value
+    CHECK(ReferenceCrc32Mpeg2(CHECK_STRING, sizeof(CHECK_STRING)) == 0x0376E6E7);
+
+    // One word 0x04030201, shifted in as 04 03 02 01
+    const uint8_t word[] = { 0x01, 0x02, 0x03, 0x04 };
+    const uint8_t wordMsbFirst[] = { 0x04, 0x03, 0x02, 0x01 };
+    CHECK(Crc32::Calculate(word, sizeof(word)) == ReferenceCrc32Mpeg2(wordMsbFirst, sizeof(wordMsbFirst)));
+
+    CHECK(Crc32::Calculate(CHECK_STRING, 0) == 0xFFFFFFFF);
+    CHECK(Crc32::Calculate(CHECK_STRING, sizeof(CHECK_STRING)) == ReferenceCrc32Stm32(CHECK_STRING, sizeof(CHECK_STRING)));
+
+    for (int iter = 0; iter < 2000; iter++) {
+        std::vector<uint8_t> data = RandomData(rand() % 300);
+        uint32_t oneShot = Crc32::Calculate(data.data(), (uint32_t)data.size());
+        CHECK(oneShot == ReferenceCrc32Stm32(data.data(), data.size()));
+
+        Crc32 chunked;
+        AddInChunks(chunked, data);
+        CHECK(chunked.Value() == oneShot);
+
+        // Value() pads a copy of the pending tail, adding more data afterwards must not be affected
+        Crc32 continued;
+        size_t split = data.empty() ? 0 : rand() % data.size();
+        continued.Add(data.data(), (uint32_t)split);
+        (void)continued.Value();
+        continued.Add(data.data() + split, (uint32_t)(data.size() - split));
+        CHECK(continued.Value() == oneShot);
+
+        // Unaligned start
+        if (data.size() > 1)
+            CHECK(Crc32::Calculate(data.data() + 1, (uint32_t)data.size() - 1) == ReferenceCrc32Stm32(data.data() + 1, data.size() - 1));
+    }
+}
+
+int main()
+{
+    srand(1);
+    TestCrc16();
+    TestCrc32();
+    return TestResult("CrcTest");
+}
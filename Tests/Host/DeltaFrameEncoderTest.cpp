@@ -0,0 +1,295 @@
+/**
+ ******************************************************************************
+ * File Name          : DeltaFrameEncoderTest.cpp
+ * Description        : Round trip and frame size tests for DeltaFrameEncoder,
+ *    decoded by a ground side decoder written from the frame layout in
+ *    DeltaFrameEncoder.hpp and RadioFrames.md.
+ ******************************************************************************
+*/
+#include "DeltaFrameEncoder.hpp"
+#include "TestCommon.hpp"
+
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+/* Constants -----------------------------------------------------------------*/
+constexpr uint8_t NUM_VALUES = 9;
+constexpr uint8_t STREAM_ID = 1;
+constexpr uint16_t KEYFRAME_INTERVAL = 10;
+
+typedef DeltaFrameEncoder<NUM_VALUES> Encoder;
+
+/* Decoder -------------------------------------------------------------------*/
+/**
+ * @brief Ground side decoder for one stream, drops delta frames after a sequence gap until the next keyframe
+ */
+class Decoder
+{
+public:
+    enum Result { DECODED, SKIPPED, MALFORMED };
+
+    Decoder() : synced_(false), lastSequence_(0), timestampMs_(0), values_() {}
+
+    Result Decode(const uint8_t* frame, uint16_t len)
+    {
+        const uint8_t* pos = frame;
+        const uint8_t* end = frame + len;
+        if (len < DELTA_FRAME_HEADER_SIZE || (frame[0] & ~DELTA_FRAME_KEYFRAME_FLAG) != STREAM_ID)
+            return MALFORMED;
+
+        bool isKeyframe = (frame[0] & DELTA_FRAME_KEYFRAME_FLAG) != 0;
+        uint16_t sequence = (uint16_t)(frame[1] | (frame[2] << 8));
+        pos += DELTA_FRAME_HEADER_SIZE;
+
+        bool inOrder = synced_ && sequence == (uint16_t)(lastSequence_ + 1);
+        lastSequence_ = sequence;
+        if (!isKeyframe && !inOrder) {
+            synced_ = false;
+            return SKIPPED;
+        }
+
+        uint32_t time;
+        if (!GetVarint(pos, end, time))
+            return MALFORMED;
+        timestampMs_ = isKeyframe ? time : timestampMs_ + time;
+
+        for (uint8_t i = 0; i < NUM_VALUES; i++) {
+            uint32_t zz;
+            if (!GetVarint(pos, end, zz))
+                return MALFORMED;
+            int32_t v = (int32_t)((zz >> 1) ^ (0U - (zz & 1)));
+            values_[i] = isKeyframe ? v : (int32_t)((uint32_t)values_[i] + (uint32_t)v);
+        }
+
+        synced_ = true;
+        return (pos == end) ? DECODED : MALFORMED;
+    }
+
+    uint32_t TimestampMs() const { return timestampMs_; }
+    const int32_t* Values() const { return values_; }
+
+private:
+    static bool GetVarint(const uint8_t*& pos, const uint8_t* end, uint32_t& v)
+    {
+        v = 0;
+        for (uint8_t shift = 0; pos < end && shift < 35; shift += 7) {
+            uint8_t b = *pos++;
+            v |= (uint32_t)(b & 0x7F) << shift;
+            if ((b & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool synced_;
+    uint16_t lastSequence_;
+    uint32_t timestampMs_;
+    int32_t values_[NUM_VALUES];
+};
+
+/* Helpers -------------------------------------------------------------------*/
+static bool IsKeyframe(const uint8_t* frame) { return (frame[0] & DELTA_FRAME_KEYFRAME_FLAG) != 0; }
+
+/**
+ * @brief Encodes one sample, checks the size bound and that the decoder gets the sample back
+ * @return Size of the encoded frame
+ */
+static uint16_t EncodeAndCheck(Encoder& enc, Decoder& dec, const int32_t (&values)[NUM_VALUES], uint32_t timeMs, uint8_t* frame)
+{
+    uint16_t len = enc.Encode(values, timeMs, frame);
+    CHECK(len <= Encoder::MAX_FRAME_SIZE);
+    CHECK(dec.Decode(frame, len) == Decoder::DECODED);
+    CHECK(dec.TimestampMs() == timeMs);
+    CHECK(memcmp(dec.Values(), values, sizeof(values)) == 0);
+    return len;
+}
+
+/* Tests ---------------------------------------------------------------------*/
+static void TestKeyframeAndDelta()
+{
+    Encoder enc(STREAM_ID, KEYFRAME_INTERVAL);
+    Decoder dec;
+    uint8_t frame[Encoder::MAX_FRAME_SIZE];
+
+    int32_t values[NUM_VALUES] = { 0, 1, -1, 63, -64, 64, 1000, -1000, 1000000 };
+
+    // First frame is a keyframe: header, 2 byte timestamp (200 ms), then zig-zag 0,2,1,126,127 take 1 byte,
+    // 128 and 2000/1999 take 2 bytes, 2000000 takes 3 bytes
+    uint16_t len = EncodeAndCheck(enc, dec, values, 200, frame);
+    CHECK(IsKeyframe(frame));
+    CHECK(frame[0] == (STREAM_ID | DELTA_FRAME_KEYFRAME_FLAG) && frame[1] == 0 && frame[2] == 0);
+    CHECK(len == DELTA_FRAME_HEADER_SIZE + 2 + 5 * 1 + 3 * 2 + 3);
+
+    // Small changes take one byte per value, including the 10 ms timestamp delta
+    for (uint8_t i = 0; i < NUM_VALUES; i++)
+        values[i] += (i % 2 == 0) ? 3 : -3;
+    len = EncodeAndCheck(enc, dec, values, 210, frame);
+    CHECK(!IsKeyframe(frame));
+    CHECK(frame[1] == 1 && frame[2] == 0);
+    CHECK(len == DELTA_FRAME_HEADER_SIZE + 1 + NUM_VALUES);
+
+    // Unchanged values still take one byte each
+    len = EncodeAndCheck(enc, dec, values, 210, frame);
+    CHECK(len == DELTA_FRAME_HEADER_SIZE + 1 + NUM_VALUES);
+}
+
+static void TestKeyframeInterval()
+{
+    Encoder enc(STREAM_ID, KEYFRAME_INTERVAL);
+    Decoder dec;
+    uint8_t frame[Encoder::MAX_FRAME_SIZE];
+    int32_t values[NUM_VALUES] = {};
+
+    for (uint16_t n = 0; n < 5 * KEYFRAME_INTERVAL; n++) {
+        values[n % NUM_VALUES] += (int32_t)n;
+        EncodeAndCheck(enc, dec, values, n * 10, frame);
+        CHECK(IsKeyframe(frame) == (n % KEYFRAME_INTERVAL == 0));
+    }
+}
+
+static void TestWrapAround()
+{
+    Encoder enc(STREAM_ID, 0xFFFF);
+    Decoder dec;
+    uint8_t frame[Encoder::MAX_FRAME_SIZE];
+
+    // Keyframe of extreme values, with a timestamp about to wrap past 2^32
+    int32_t values[NUM_VALUES] = { INT_MAX, INT_MIN, 0, -1, 1, INT_MAX, INT_MIN, 12345, -12345 };
+    EncodeAndCheck(enc, dec, values, UINT32_MAX - 5, frame);
+    memset(values, 0, sizeof(values));
+    EncodeAndCheck(enc, dec, values, UINT32_MAX - 4, frame);
+
+    // The largest deltas, 0 to INT_MIN and 0 to INT_MAX, take 5 bytes each. The timestamp wraps to a 9 ms delta
+    for (uint8_t i = 0; i < NUM_VALUES; i++)
+        values[i] = (i % 2 == 0) ? INT_MIN : INT_MAX;
+    uint16_t len = EncodeAndCheck(enc, dec, values, 4, frame);
+    CHECK(!IsKeyframe(frame));
+    CHECK(len == Encoder::MAX_FRAME_SIZE - DELTA_VARINT_MAX_BYTES + 1);
+
+    // INT_MAX and INT_MIN are 1 apart in wrapping arithmetic, so stepping across the boundary stays 1 byte
+    for (uint8_t i = 0; i < NUM_VALUES; i++)
+        values[i] = (i % 2 == 0) ? INT_MAX : INT_MIN;
+    len = EncodeAndCheck(enc, dec, values, 5, frame);
+    CHECK(len == DELTA_FRAME_HEADER_SIZE + 1 + NUM_VALUES);
+}
+
+static void TestSequenceWrap()
+{
+    Encoder enc(STREAM_ID, 0xFFFF);
+    Decoder dec;
+    uint8_t frame[Encoder::MAX_FRAME_SIZE];
+    int32_t values[NUM_VALUES] = {};
+
+    // Only the first frame is a keyframe, so every delta across the 0xFFFF -> 0 wrap must decode in order
+    for (uint32_t n = 0; n < 0x10000 + 10; n++) {
+        values[n % NUM_VALUES] = (int32_t)(n * 7);
+        EncodeAndCheck(enc, dec, values, n, frame);
+        CHECK(frame[1] == (uint8_t)n && frame[2] == (uint8_t)(n >> 8));
+    }
+}
+
+static void TestForcedKeyframeAfterDrop()
+{
+    Encoder enc(STREAM_ID, KEYFRAME_INTERVAL);
+    Decoder dec;
+    uint8_t frame[Encoder::MAX_FRAME_SIZE];
+    int32_t values[NUM_VALUES] = {};
+
+    EncodeAndCheck(enc, dec, values, 0, frame);
+    values[0] = 100;
+    EncodeAndCheck(enc, dec, values, 10, frame);
+
+    // Dropped by the link budget, the decoder never sees it
+    values[0] = 200;
+    enc.Encode(values, 20, frame);
+    enc.ForceKeyframe();
+
+    values[0] = 300;
+    uint16_t len = enc.Encode(values, 30, frame);
+    CHECK(IsKeyframe(frame));
+    CHECK(dec.Decode(frame, len) == Decoder::DECODED);
+    CHECK(dec.Values()[0] == 300 && dec.TimestampMs() == 30);
+
+    // The keyframe restarts the interval, the frames after it are deltas again
+    for (uint16_t n = 1; n < KEYFRAME_INTERVAL; n++) {
+        values[1] = n;
+        EncodeAndCheck(enc, dec, values, 30 + n, frame);
+        CHECK(!IsKeyframe(frame));
+    }
+    EncodeAndCheck(enc, dec, values, 40, frame);
+    CHECK(IsKeyframe(frame));
+
+    // A request only forces one keyframe, however often it is made
+    enc.ForceKeyframe();
+    enc.ForceKeyframe();
+    EncodeAndCheck(enc, dec, values, 41, frame);
+    CHECK(IsKeyframe(frame));
+    EncodeAndCheck(enc, dec, values, 42, frame);
+    CHECK(!IsKeyframe(frame));
+
+    // Without a forced keyframe, the decoder must skip deltas after a gap until the interval keyframe
+    enc.Encode(values, 43, frame);
+    int skipped = 0;
+    for (uint32_t t = 44; ; t++) {
+        values[2] = (int32_t)t;
+        len = enc.Encode(values, t, frame);
+        Decoder::Result res = dec.Decode(frame, len);
+        if (res == Decoder::SKIPPED) {
+            CHECK(!IsKeyframe(frame));
+            skipped++;
+            continue;
+        }
+        CHECK(res == Decoder::DECODED && IsKeyframe(frame));
+        CHECK(dec.Values()[2] == (int32_t)t);
+        break;
+    }
+    CHECK(skipped == KEYFRAME_INTERVAL - 3);    // Frames 3 to 9 after the keyframe, frame 2 was the lost one
+}
+
+static void TestRandomRoundTrip()
+{
+    srand(1);
+    Encoder enc(STREAM_ID, KEYFRAME_INTERVAL);
+    Decoder dec;
+    uint8_t frame[Encoder::MAX_FRAME_SIZE];
+    int32_t values[NUM_VALUES] = {};
+    uint32_t timeMs = 0;
+    uint32_t totalBytes = 0, frames = 0;
+
+    // Random walks like sensor data, with a random ~2% of frames dropped and a keyframe forced after each drop
+    for (int n = 0; n < 200000; n++) {
+        for (uint8_t i = 0; i < NUM_VALUES; i++)
+            values[i] += (rand() % 2001) - 1000;
+        timeMs += 1 + rand() % 20;
+
+        uint16_t len = enc.Encode(values, timeMs, frame);
+        CHECK(len <= Encoder::MAX_FRAME_SIZE);
+        totalBytes += len;
+        frames++;
+
+        if (rand() % 50 == 0) {
+            enc.ForceKeyframe();
+            continue;
+        }
+
+        CHECK(dec.Decode(frame, len) == Decoder::DECODED);
+        CHECK(dec.TimestampMs() == timeMs);
+        CHECK(memcmp(dec.Values(), values, sizeof(values)) == 0);
+    }
+
+    // Deltas of up to +-1000 take 2 bytes each, so frames stay well under the 12 + 36 bytes of raw values
+    printf("DeltaFrameEncoderTest: %.1f bytes per frame on average, max %d\n", (double)totalBytes / frames, Encoder::MAX_FRAME_SIZE);
+    CHECK(totalBytes < frames * (DELTA_FRAME_HEADER_SIZE + 1 + 2 * NUM_VALUES + 2));
+}
+
+int main()
+{
+    TestKeyframeAndDelta();
+    TestKeyframeInterval();
+    TestWrapAround();
+    TestSequenceWrap();
+    TestForcedKeyframeAfterDrop();
+    TestRandomRoundTrip();
+    return TestResult("DeltaFrameEncoderTest");
+}
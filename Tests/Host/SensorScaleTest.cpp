@@ -0,0 +1,95 @@
+/**
+ ******************************************************************************
+ * File Name          : SensorScaleTest.cpp
+ * Description        : Checks every SensorScale against the double conversion it
+ *    replaced in the sensor tasks, over the full raw input range of the sensor.
+ ******************************************************************************
+*/
+#include "SensorScale.hpp"
+#include "TestCommon.hpp"
+
+#include <cstdlib>
+
+/* Constants -----------------------------------------------------------------*/
+constexpr int32_t MAX_ERROR_LSB = 0;    // The fixed point result must match the old double result exactly
+
+/* Reference -----------------------------------------------------------------*/
+// The conversions the sensor tasks used before SensorScale, each cast to the Data.h field type
+static int32_t DoubleImuAccel(int32_t raw) { return (int32_t)(raw * 0.732); }
+static int32_t DoubleImuGyro(int32_t raw) { return (int32_t)(raw * 8.75); }
+static int32_t DoubleImuMag(int32_t raw) { return (int32_t)(raw * 0.14); }
+
+static int32_t DoubleBatteryVoltage(int32_t raw)
+{
+    double vi = (3.3 / 4095) * (double)raw;
+    return (int32_t)(uint32_t)((vi * 4) * 1000);
+}
+
+static int32_t DoublePressureTransducer(int32_t raw)
+{
+    static const double PRESSURE_SCALE = 1.5220883534136546;
+    double vi = (3.3 / 4095) * (double)raw;
+    return (int32_t)((250 * (vi * PRESSURE_SCALE) - 125) * 1000);
+}
+
+/* Helpers -------------------------------------------------------------------*/
+/**
+ * @brief Runs a scale and its double reference over [first, last], prints and checks the largest difference
+ */
+template<typename Scale>
+static void CheckScale(const char* name, int32_t (*reference)(int32_t), int32_t first, int32_t last)
+{
+    int32_t maxError = 0;
+    int32_t worstRaw = first;
+    for (int32_t raw = first; raw <= last; raw++) {
+        int32_t error = abs(Scale::Apply(raw) - reference(raw));
+        if (error > maxError) {
+            maxError = error;
+            worstRaw = raw;
+        }
+    }
+
+    printf("SensorScaleTest: %-20s raw %6d..%5d, max error %d LSB", name, first, last, maxError);
+    if (maxError != 0)
+        printf(" at raw %d", worstRaw);
+    printf("\n");
+
+    CHECK(maxError <= MAX_ERROR_LSB);
+}
+
+/* Tests ---------------------------------------------------------------------*/
+static void TestImuScales()
+{
+    // Every int16 register value, the FIFO average of int16 samples stays in the same range
+    CheckScale<ImuAccelScale>("ImuAccelScale", DoubleImuAccel, INT16_MIN, INT16_MAX);
+    CheckScale<ImuGyroScale>("ImuGyroScale", DoubleImuGyro, INT16_MIN, INT16_MAX);
+    CheckScale<ImuMagScale>("ImuMagScale", DoubleImuMag, INT16_MIN, INT16_MAX);
+}
+
+static void TestAdcScales()
+{
+    // Every 12 bit ADC code
+    CheckScale<BatteryVoltageScale>("BatteryVoltageScale", DoubleBatteryVoltage, 0, ADC_MAX_COUNT);
+    CheckScale<PressureTransducerScale>("PressureTransducer", DoublePressureTransducer, 0, ADC_MAX_COUNT);
+}
+
+static void TestRounding()
+{
+    // Exact results must not truncate to one below, and negative results truncate toward zero
+    CHECK(ImuGyroScale::Apply(4) == 35);
+    CHECK(ImuGyroScale::Apply(-4) == -35);
+    CHECK(ImuGyroScale::Apply(-1) == -8);
+    CHECK(ImuAccelScale::Apply(250) == 183);
+    CHECK(ImuAccelScale::Apply(-1) == 0);
+    CHECK(BatteryVoltageScale::Apply(ADC_MAX_COUNT) == ADC_FULL_SCALE_MV * 4);
+    CHECK(BatteryVoltageScale::Apply(0) == 0);
+    CHECK(PressureTransducerScale::Apply(0) == -125000);
+}
+
+int main()
+{
+    TestImuScales();
+    TestAdcScales();
+    TestRounding();
+    return TestResult("SensorScaleTest");
+}
@@ -0,0 +1,28 @@
+/**
+ ******************************************************************************
+ * File Name          : TestCommon.hpp
+ * Description        : Minimal check macro shared by the host tests, each test
+ *    is a separate executable that returns non-zero if any check failed.
+ ******************************************************************************
+*/
+#ifndef SOAR_TESTS_HOST_TEST_COMMON_HPP_
+#define SOAR_TESTS_HOST_TEST_COMMON_HPP_
+#include <cstdio>
+
+static int g_failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++; \
+        } \
+    } while (0)
+
+// Prints the result and gives the process exit code
+static inline int TestResult(const char* name)
+{
+    printf("%s: %s\n", name, (g_failures == 0) ? "PASS" : "FAIL");
+    return (g_failures == 0) ? 0 : 1;
+}
+
+#endif    // SOAR_TESTS_HOST_TEST_COMMON_HPP_